@@ -1,11 +1,26 @@
 #include "Terremesh/Required.h"
 
-#include "Terremesh/Remesh/MeshReader.h"
 #include "Terremesh/Remesh/Mesh.h"
-#include "Terremesh/Remesh/MeshWriter.h"
+#include "Terremesh/Remesh/MeshFile.h"
+#include "Terremesh/Remesh/MeshPreprocessor.h"
+#include "Terremesh/Remesh/ProgressiveMeshWriter.h"
+#include "Terremesh/Remesh/LevelOfDetailBufferWriter.h"
+#include "Terremesh/Remesh/VertexCacheOptimizer.h"
+#include "Terremesh/Remesh/MeshletBuilder.h"
+#include "Terremesh/Remesh/MeshletWriter.h"
+#include "Terremesh/Remesh/CollapseLogReader.h"
+#include "Terremesh/Remesh/CollapseLogWriter.h"
 #include "Terremesh/IProgressListener.h"
+#include "Terremesh/ISnapshotListener.h"
 
 #include "Terremesh/QuadricErrorMetric/QuadricErrorMetricMethod.h"
+#include "Terremesh/Memoryless/MemorylessMethod.h"
+#include "Terremesh/Batch/BatchManifestReader.h"
+#include "Terremesh/Batch/BatchProcessor.h"
+#include "Terremesh/Cache/ResultCache.h"
+#include "Terremesh/IO/MemoryStreamBuffer.h"
+#include "Terremesh/IO/FileStream.h"
+#include "Terremesh/Threading/TaskScheduler.h"
 
 class ConsoleProgressListener 
 	: public Terremesh::IProgressListener
@@ -58,6 +73,213 @@ private:
 	int m_Progress;
 };
 
+/// Makes file path of level of detail.
+///
+/// @remarks
+///		Level N of "name.obj" is written into "name.lodN.obj".
+static std::string MakeLevelPath(const std::string& path, size_t index)
+{
+	std::ostringstream suffix;
+	suffix << ".lod" << index;
+
+	// Level suffix goes before format extension, not compression one
+	std::string result = Terremesh::IO::FilePath::GetContentsPath(path);
+	std::string compression = path.substr(result.size());
+	size_t separator = result.find_last_of("/\\");
+	size_t extension = result.find_last_of('.');
+
+	if ((extension == std::string::npos) || ((separator != std::string::npos) && (extension < separator)))
+	{
+		extension = result.size();
+	}
+
+	result.insert(extension, suffix.str());
+	return result + compression;
+}
+
+/// Reorders mesh for vertex cache and reports cache efficiency before and after.
+static void OptimizeVertexCache(const Terremesh::Remesh::VertexCacheOptimizer& optimizer, Terremesh::Remesh::Mesh& mesh, Terremesh::IProgressListener* listener)
+{
+	auto before = optimizer.Measure(mesh);
+	optimizer.Optimize(mesh, listener);
+	auto after = optimizer.Measure(mesh);
+
+	std::cout
+		<< "Vertex cache " << optimizer.GetCacheSize()
+		<< ": ACMR " << before.AverageCacheMissRatio << " -> " << after.AverageCacheMissRatio
+		<< ", ATVR " << before.AverageTransformToVertexRatio << " -> " << after.AverageTransformToVertexRatio
+		<< std::endl;
+}
+
+/// Partitions mesh into meshlets and writes them into file, returning false when file cannot be written.
+static bool WriteMeshlets(const Terremesh::Remesh::MeshletBuilder& builder, const Terremesh::Remesh::Mesh& mesh, const std::string& path, Terremesh::IProgressListener* listener)
+{
+	std::ofstream stream(path.c_str(), std::ios::out | std::ios::binary);
+
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	Terremesh::Remesh::MeshletSet meshlets;
+	builder.Build(mesh, meshlets, listener);
+
+	Terremesh::Remesh::MeshletWriter writer(stream);
+	return writer.Write(meshlets, listener);
+}
+
+/// Writes each level of detail into separate file.
+class LevelOfDetailWriter
+	: public Terremesh::ISnapshotListener
+{
+public:
+	LevelOfDetailWriter(const std::string& path, unsigned int positionBits, const Terremesh::Remesh::VertexCacheOptimizer* optimizer, Terremesh::IProgressListener* listener, Terremesh::Threading::TaskScheduler* scheduler)
+		: m_Path(path)
+		, m_PositionBits(positionBits)
+		, m_Optimizer(optimizer)
+		, m_MeshletBuilder(nullptr)
+		, m_Listener(listener)
+		, m_Scheduler(scheduler)
+		, m_Failed(false)
+	{
+	}
+
+	/// Determines whether any level or its meshlets could not be written.
+	bool HasFailed() const
+	{
+		return m_Failed;
+	}
+
+	/// Writes meshlets of each level into file derived from path.
+	void SetMeshlets(const Terremesh::Remesh::MeshletBuilder* builder, const std::string& path)
+	{
+		m_MeshletBuilder = builder;
+		m_MeshletPath = path;
+	}
+
+	virtual void OnSnapshot(size_t index, const Terremesh::Remesh::Mesh& mesh)
+	{
+		const Terremesh::Remesh::Mesh* output = &mesh;
+		Terremesh::Remesh::Mesh optimized;
+
+		if (m_Optimizer != nullptr)
+		{
+			optimized = mesh;
+			OptimizeVertexCache(*m_Optimizer, optimized, m_Listener);
+			output = &optimized;
+		}
+
+		auto path = MakeLevelPath(m_Path, index);
+
+		if (!Terremesh::Remesh::MeshFile::Write(*output, path, m_PositionBits, m_Listener, m_Scheduler))
+		{
+			std::cerr << "Cannot write " << path << std::endl;
+			m_Failed = true;
+		}
+
+		if (m_MeshletBuilder != nullptr)
+		{
+			auto meshletPath = MakeLevelPath(m_MeshletPath, index);
+
+			if (!WriteMeshlets(*m_MeshletBuilder, *output, meshletPath, m_Listener))
+			{
+				std::cerr << "Cannot write " << meshletPath << std::endl;
+				m_Failed = true;
+			}
+		}
+	}
+
+private:
+	std::string m_Path;
+	unsigned int m_PositionBits;
+	const Terremesh::Remesh::VertexCacheOptimizer* m_Optimizer;
+	const Terremesh::Remesh::MeshletBuilder* m_MeshletBuilder;
+	std::string m_MeshletPath;
+	Terremesh::IProgressListener* m_Listener;
+	Terremesh::Threading::TaskScheduler* m_Scheduler;
+	bool m_Failed;
+};
+
+/// Forwards collapses to multiple listeners.
+class CollapseListenerList
+	: public Terremesh::ICollapseListener
+{
+public:
+	void Add(Terremesh::ICollapseListener* listener)
+	{
+		m_Listeners.push_back(listener);
+	}
+
+	virtual void OnCollapse(const Terremesh::Remesh::EdgeCollapse& collapse)
+	{
+		for (auto it = m_Listeners.begin(); it != m_Listeners.end(); ++it)
+		{
+			(*it)->OnCollapse(collapse);
+		}
+	}
+
+private:
+	std::vector<Terremesh::ICollapseListener*> m_Listeners;
+};
+
+/// Forwards snapshots to multiple listeners.
+class SnapshotListenerList
+	: public Terremesh::ISnapshotListener
+{
+public:
+	void Add(Terremesh::ISnapshotListener* listener)
+	{
+		m_Listeners.push_back(listener);
+	}
+
+	bool IsEmpty() const
+	{
+		return m_Listeners.empty();
+	}
+
+	virtual void OnSnapshot(size_t index, const Terremesh::Remesh::Mesh& mesh)
+	{
+		for (auto it = m_Listeners.begin(); it != m_Listeners.end(); ++it)
+		{
+			(*it)->OnSnapshot(index, mesh);
+		}
+	}
+
+private:
+	std::vector<Terremesh::ISnapshotListener*> m_Listeners;
+};
+
+/// Parses comma separated list of values.
+template <typename T>
+static void ParseList(const char* text, std::vector<T>& values)
+{
+	std::istringstream stream(text);
+	std::string item;
+
+	while (std::getline(stream, item, ','))
+	{
+		values.push_back((T)atof(item.c_str()));
+	}
+}
+
+/// Remeshes mesh using context of chosen storage precision and index width.
+template <typename TScalar>
+static void ProcessMesh(const Terremesh::QuadricErrorMetric::QuadricErrorMetricMethod& method, Terremesh::Remesh::Mesh& mesh, const std::vector<size_t>& targets, bool smallIndices, Terremesh::ICollapseListener* collapses, Terremesh::ISnapshotListener* snapshots, Terremesh::IProgressListener* listener, Terremesh::Threading::TaskScheduler* scheduler)
+{
+	if (smallIndices)
+	{
+		Terremesh::QuadricErrorMetric::BasicQuadricErrorMetricContext<TScalar, unsigned short> context;
+		context.SetCollapseListener(collapses);
+		method.Process(mesh, targets, context, snapshots, listener, scheduler);
+	}
+	else
+	{
+		Terremesh::QuadricErrorMetric::BasicQuadricErrorMetricContext<TScalar, unsigned int> context;
+		context.SetCollapseListener(collapses);
+		method.Process(mesh, targets, context, snapshots, listener, scheduler);
+	}
+}
+
 #include "Terremesh/optionparser.h"
 
 enum OptionIndex
@@ -68,6 +290,29 @@ enum OptionIndex
 	OptionIndex_Percent,
 	OptionIndex_Target,
 	OptionIndex_Method,
+	OptionIndex_Cache,
+	OptionIndex_Batch,
+	OptionIndex_Jobs,
+	OptionIndex_Memory,
+	OptionIndex_Threads,
+	OptionIndex_Reorder,
+	OptionIndex_Weld,
+	OptionIndex_AreaWeights,
+	OptionIndex_Precision,
+	OptionIndex_Index,
+	OptionIndex_Placement,
+	OptionIndex_LevelBuffers,
+	OptionIndex_VertexCache,
+	OptionIndex_Meshlets,
+	OptionIndex_MeshletSize,
+	OptionIndex_PositionBits,
+	OptionIndex_GridSpacing,
+	OptionIndex_GridOrigin,
+	OptionIndex_HeightScale,
+	OptionIndex_RasterSize,
+	OptionIndex_Progressive,
+	OptionIndex_Log,
+	OptionIndex_Replay,
 	OptionIndex_Help,
 };
 
@@ -75,22 +320,49 @@ const option::Descriptor usage[] =
 {
 	{OptionIndex_Unknown, 0, "", "", option::Arg::None, "Usage: trc [options]\n\n"},
 	{OptionIndex_Help, 0, "", "help", option::Arg::None,			"  --help              Print usage and exit"},
-	{OptionIndex_Input, 0, "i", "input", option::Arg::Optional,		"  --input=FILEPATH    Sets input file name"},
-	{OptionIndex_Output, 0, "o", "output", option::Arg::Optional,	"  --output=FILEPATH   Sets output file name"},
-	{OptionIndex_Percent, 0, "r", "ratio", option::Arg::Optional,   "  --ratio=RATIO       Sets removed triangles ratio"},
-	{OptionIndex_Target, 0, "t", "target", option::Arg::Optional,   "  --target=TRIANGLES  Sets target number of triangles"},
-	{OptionIndex_Method, 0, "m", "method", option::Arg::Optional,   "  --method=METHOD     Sets used method"},
+	{OptionIndex_Input, 0, "i", "input", option::Arg::Optional,		"  --input=FILEPATH    Sets input file name, - for standard input"},
+	{OptionIndex_Output, 0, "o", "output", option::Arg::Optional,	"  --output=FILEPATH   Sets output file name, - for standard output in .obj format"},
+	{OptionIndex_Percent, 0, "r", "ratio", option::Arg::Optional,   "  --ratio=RATIO[,..]  Sets removed triangles ratio, one level of detail per value"},
+	{OptionIndex_Target, 0, "t", "target", option::Arg::Optional,   "  --target=TRIS[,..]  Sets target number of triangles, one level of detail per value"},
+	{OptionIndex_Method, 0, "m", "method", option::Arg::Optional,   "  --method=METHOD     Sets used method, qem or memoryless"},
+	{OptionIndex_Progressive, 0, "p", "progressive", option::Arg::Optional, "  --progressive=FILEPATH  Writes progressive mesh into file"},
+	{OptionIndex_LevelBuffers, 0, "", "lod-buffers", option::Arg::Optional, "  --lod-buffers=FILEPATH  Writes shared vertex buffer and index buffer per level of detail, implies endpoint placement"},
+	{OptionIndex_Log, 0, "l", "log", option::Arg::Optional,         "  --log=FILEPATH      Records collapse log into file"},
+	{OptionIndex_Replay, 0, "", "replay", option::Arg::Optional,    "  --replay=FILEPATH   Applies collapse log instead of remeshing"},
+	{OptionIndex_Cache, 0, "c", "cache", option::Arg::Optional,     "  --cache=DIRECTORY   Reuses results cached in directory"},
+	{OptionIndex_Batch, 0, "b", "batch", option::Arg::Optional,     "  --batch=MANIFEST    Converts all jobs listed in manifest file"},
+	{OptionIndex_Jobs, 0, "j", "jobs", option::Arg::Optional,       "  --jobs=COUNT        Sets number of concurrent batch jobs"},
+	{OptionIndex_Memory, 0, "", "memory", option::Arg::Optional,    "  --memory=MEGABYTES  Sets memory budget for batch jobs"},
+	{OptionIndex_Reorder, 0, "", "reorder", option::Arg::Optional,  "  --reorder=CURVE     Reorders input along morton or hilbert curve"},
+	{OptionIndex_Weld, 0, "w", "weld", option::Arg::Optional,       "  --weld[=EPSILON]    Merges vertices with equal or epsilon grid quantized positions"},
+	{OptionIndex_AreaWeights, 0, "", "area-weights", option::Arg::None, "  --area-weights      Weights plane quadrics by triangle area"},
+	{OptionIndex_Precision, 0, "", "precision", option::Arg::Optional, "  --precision=TYPE    Stores positions and quadrics as float or double"},
+	{OptionIndex_Index, 0, "", "index", option::Arg::Optional,      "  --index=WIDTH       Sets vertex index width to 16, 32 or auto"},
+	{OptionIndex_Placement, 0, "", "placement", option::Arg::Optional, "  --placement=MODE    Places merged vertex at optimal point or at edge endpoint"},
+	{OptionIndex_VertexCache, 0, "", "vertex-cache", option::Arg::Optional, "  --vertex-cache[=SIZE]  Reorders output triangles and vertices for vertex cache of SIZE entries, 16 by default"},
+	{OptionIndex_Meshlets, 0, "", "meshlets", option::Arg::Optional, "  --meshlets=FILEPATH  Writes meshlets with bounding spheres and normal cones of output into file"},
+	{OptionIndex_MeshletSize, 0, "", "meshlet-size", option::Arg::Optional, "  --meshlet-size=VERTS,TRIS  Sets meshlet limits, 64,124 by default"},
+	{OptionIndex_PositionBits, 0, "", "position-bits", option::Arg::Optional, "  --position-bits=BITS  Sets bits per coordinate of compressed .tmc output, 16 by default"},
+	{OptionIndex_GridSpacing, 0, "", "grid-spacing", option::Arg::Optional, "  --grid-spacing=X[,Y]  Sets distance between heightmap samples, 1 by default"},
+	{OptionIndex_GridOrigin, 0, "", "grid-origin", option::Arg::Optional, "  --grid-origin=X,Y,Z  Sets position of south-west heightmap corner, 0,0,0 by default"},
+	{OptionIndex_HeightScale, 0, "", "height-scale", option::Arg::Optional, "  --height-scale=SCALE  Scales heightmap samples, 1 by default"},
+	{OptionIndex_RasterSize, 0, "", "raster-size", option::Arg::Optional, "  --raster-size=WIDTH,HEIGHT  Sets size of raw heightmap, square by default"},
+	{OptionIndex_Threads, 0, "", "threads", option::Arg::Optional,  "  --threads=COUNT     Sets number of threads, hardware concurrency by default"},
 	{0, 0, 0, 0, 0, 0},
 };
 
-int main(int argc, char* argv[])
+/// Prints program banner.
+static void PrintBanner()
 {
 	std::cout
 		<< "Karol Grzybowski & Piotr Ruchwa" << std::endl
 		<< "(C) 2012" << std::endl
 		<< "Terremesh.Converter" << std::endl
 		<< std::endl;
+}
 
+int main(int argc, char* argv[])
+{
 #if 1
 	argc -= (argc > 0) ? 1 : 0;
 	argv += (argc > 0) ? 1 : 0;
@@ -101,6 +373,14 @@ int main(int argc, char* argv[])
 
 	option::Parser parser(usage, argc, argv, options, buffer);
 
+	// Mesh written to standard output must not be mixed with messages
+	if ((options[OptionIndex_Output].arg != nullptr) && Terremesh::IO::FilePath::IsStandardStream(options[OptionIndex_Output].arg))
+	{
+		std::cout.rdbuf(std::cerr.rdbuf());
+	}
+
+	PrintBanner();
+
 	if (parser.error())
 	{
 		std::cerr << "Cannot parser args" << std::endl;
@@ -113,6 +393,287 @@ int main(int argc, char* argv[])
 		return 0;
 	}
 
+	Terremesh::Remesh::MeshPreprocessor preprocessor;
+	Terremesh::Remesh::SpaceFillingCurve curve = Terremesh::Remesh::SpaceFillingCurve_None;
+
+	if (options[OptionIndex_Reorder].arg != nullptr)
+	{
+		if (!Terremesh::Remesh::MeshReorderer::ParseCurve(options[OptionIndex_Reorder].arg, curve))
+		{
+			std::cerr << "Unknown curve " << options[OptionIndex_Reorder].arg << std::endl;
+			return -1;
+		}
+
+		preprocessor.SetCurve(curve);
+	}
+
+	if (options[OptionIndex_Weld])
+	{
+		preprocessor.SetWeldEpsilon(options[OptionIndex_Weld].arg != nullptr ? atof(options[OptionIndex_Weld].arg) : 0.0);
+	}
+
+	// Zero disables vertex cache optimization of output
+	unsigned int vertexCacheSize = 0;
+
+	if (options[OptionIndex_VertexCache])
+	{
+		vertexCacheSize = options[OptionIndex_VertexCache].arg != nullptr ? (unsigned int)atol(options[OptionIndex_VertexCache].arg) : 16;
+
+		if (vertexCacheSize == 0)
+		{
+			std::cerr << "Invalid vertex cache size" << std::endl;
+			return -1;
+		}
+	}
+
+	Terremesh::Remesh::VertexCacheOptimizer vertexCacheOptimizer(vertexCacheSize);
+	const Terremesh::Remesh::VertexCacheOptimizer* optimizer = (vertexCacheSize != 0) ? &vertexCacheOptimizer : nullptr;
+
+	const char* meshletsFilePath = options[OptionIndex_Meshlets].arg;
+	std::vector<unsigned int> meshletSize;
+
+	if (options[OptionIndex_MeshletSize].arg != nullptr)
+	{
+		ParseList(options[OptionIndex_MeshletSize].arg, meshletSize);
+
+		if ((meshletSize.size() != 2) || (meshletSize[0] < 3) || (meshletSize[0] > 256) || (meshletSize[1] == 0))
+		{
+			std::cerr << "Invalid meshlet size " << options[OptionIndex_MeshletSize].arg << std::endl;
+			return -1;
+		}
+	}
+	else
+	{
+		meshletSize.push_back(64);
+		meshletSize.push_back(124);
+	}
+
+	Terremesh::Remesh::MeshletBuilder meshletBuilder(meshletSize[0], meshletSize[1]);
+
+	// Output with .tmc extension is compressed
+	unsigned int positionBits = Terremesh::Remesh::MeshFile::DefaultPositionBits;
+
+	if (options[OptionIndex_PositionBits].arg != nullptr)
+	{
+		positionBits = (unsigned int)atol(options[OptionIndex_PositionBits].arg);
+
+		if ((positionBits < 1) || (positionBits > 24))
+		{
+			std::cerr << "Invalid position bits " << options[OptionIndex_PositionBits].arg << std::endl;
+			return -1;
+		}
+	}
+
+	// Heightmap input is placed on grid
+	Terremesh::Remesh::HeightmapOptions heightmap;
+
+	if (options[OptionIndex_GridSpacing].arg != nullptr)
+	{
+		std::vector<double> spacing;
+		ParseList(options[OptionIndex_GridSpacing].arg, spacing);
+
+		if ((spacing.size() < 1) || (spacing.size() > 2) || !(spacing.front() > 0.0) || !(spacing.back() > 0.0))
+		{
+			std::cerr << "Invalid grid spacing " << options[OptionIndex_GridSpacing].arg << std::endl;
+			return -1;
+		}
+
+		heightmap.SpacingX = spacing.front();
+		heightmap.SpacingY = spacing.back();
+	}
+
+	if (options[OptionIndex_GridOrigin].arg != nullptr)
+	{
+		std::vector<double> origin;
+		ParseList(options[OptionIndex_GridOrigin].arg, origin);
+
+		if (origin.size() != 3)
+		{
+			std::cerr << "Invalid grid origin " << options[OptionIndex_GridOrigin].arg << std::endl;
+			return -1;
+		}
+
+		heightmap.Origin = Terremesh::Math::Vec3(origin[0], origin[1], origin[2]);
+	}
+
+	if (options[OptionIndex_HeightScale].arg != nullptr)
+	{
+		heightmap.HeightScale = atof(options[OptionIndex_HeightScale].arg);
+	}
+
+	if (options[OptionIndex_RasterSize].arg != nullptr)
+	{
+		std::vector<unsigned int> size;
+		ParseList(options[OptionIndex_RasterSize].arg, size);
+
+		if ((size.size() != 2) || (size[0] == 0) || (size[1] == 0))
+		{
+			std::cerr << "Invalid raster size " << options[OptionIndex_RasterSize].arg << std::endl;
+			return -1;
+		}
+
+		heightmap.RawWidth = size[0];
+		heightmap.RawHeight = size[1];
+	}
+
+	const char* buffersFilePath = options[OptionIndex_LevelBuffers].arg;
+
+	// Batch jobs use quadric error metric unless other method is given
+	const char* methodName = (options[OptionIndex_Method].arg != nullptr) ? options[OptionIndex_Method].arg : "qem";
+	bool memoryless = std::string(methodName) == "memoryless";
+
+	if (!memoryless && (std::string(methodName) != "qem"))
+	{
+		std::cerr << "Unknown method " << methodName << std::endl;
+		return -1;
+	}
+
+	bool areaWeights = options[OptionIndex_AreaWeights] != nullptr;
+	bool singlePrecision = false;
+
+	if (options[OptionIndex_Precision].arg != nullptr)
+	{
+		std::string precision = options[OptionIndex_Precision].arg;
+
+		if ((precision != "float") && (precision != "double"))
+		{
+			std::cerr << "Unknown precision " << precision << std::endl;
+			return -1;
+		}
+
+		singlePrecision = precision == "float";
+	}
+
+	// Levels share vertices only when no vertex is moved
+	bool endpointPlacement = buffersFilePath != nullptr;
+
+	if (options[OptionIndex_Placement].arg != nullptr)
+	{
+		std::string placement = options[OptionIndex_Placement].arg;
+
+		if ((placement != "optimal") && (placement != "endpoint"))
+		{
+			std::cerr << "Unknown placement " << placement << std::endl;
+			return -1;
+		}
+
+		if ((placement == "optimal") && endpointPlacement)
+		{
+			std::cerr << "Level of detail buffers require endpoint placement" << std::endl;
+			return -1;
+		}
+
+		endpointPlacement = placement == "endpoint";
+	}
+
+	// Zero selects 16-bit indices whenever mesh is small enough
+	int indexWidth = 0;
+
+	if (options[OptionIndex_Index].arg != nullptr)
+	{
+		std::string index = options[OptionIndex_Index].arg;
+
+		if ((index != "auto") && (index != "16") && (index != "32"))
+		{
+			std::cerr << "Unknown index width " << index << std::endl;
+			return -1;
+		}
+
+		indexWidth = atol(index.c_str());
+	}
+
+	// Batch jobs and result cache see the same conversion
+	Terremesh::Batch::ConversionSettings settings;
+	settings.Method = methodName;
+	settings.Preprocessor = preprocessor;
+	settings.AreaWeights = areaWeights;
+	settings.SinglePrecision = singlePrecision;
+	settings.EndpointPlacement = endpointPlacement;
+	settings.IndexWidth = indexWidth;
+	settings.Optimizer = optimizer;
+	settings.PositionBits = positionBits;
+	settings.Heightmap = heightmap;
+
+	// All stages and batch jobs share single pool of threads
+	Terremesh::Threading::TaskScheduler scheduler(
+		options[OptionIndex_Threads].arg != nullptr ? atol(options[OptionIndex_Threads].arg) : 0);
+
+	if (options[OptionIndex_Batch].arg != nullptr)
+	{
+		std::ifstream manifestStream(options[OptionIndex_Batch].arg);
+
+		if (!manifestStream.is_open())
+		{
+			std::cerr << "Cannot open manifest" << std::endl;
+			return -1;
+		}
+
+		// Ratio or target given on command line is default for all jobs
+		Terremesh::Batch::BatchJob defaults;
+
+		if (options[OptionIndex_Percent].arg != nullptr)
+		{
+			defaults.HasRatio = true;
+			defaults.Ratio = atof(options[OptionIndex_Percent].arg);
+		}
+		else if (options[OptionIndex_Target].arg != nullptr)
+		{
+			defaults.HasRatio = false;
+			defaults.Target = (size_t)strtoull(options[OptionIndex_Target].arg, nullptr, 10);
+		}
+
+		std::vector<Terremesh::Batch::BatchJob> jobs;
+		Terremesh::Batch::BatchManifestReader manifestReader(manifestStream);
+
+		if (!manifestReader.Read(jobs, defaults))
+		{
+			std::cerr << "Cannot read manifest" << std::endl;
+			return -1;
+		}
+
+		int workers = 0;
+		size_t memoryLimit = 0;
+
+		if (options[OptionIndex_Jobs].arg != nullptr)
+		{
+			workers = atol(options[OptionIndex_Jobs].arg);
+		}
+
+		if (options[OptionIndex_Memory].arg != nullptr)
+		{
+			memoryLimit = (size_t)atol(options[OptionIndex_Memory].arg) * 1024 * 1024;
+		}
+
+		// Jobs write converted meshes only
+		if ((options[OptionIndex_Progressive].arg != nullptr) || (options[OptionIndex_Log].arg != nullptr) || (options[OptionIndex_Replay].arg != nullptr) ||
+			(buffersFilePath != nullptr) || (meshletsFilePath != nullptr))
+		{
+			std::cerr << "Batch mode supports no progressive mesh, collapse log, replay, buffers or meshlets" << std::endl;
+			return -1;
+		}
+
+		ConsoleProgressListener batchListener;
+		Terremesh::Batch::BatchProcessor processor(scheduler, workers, memoryLimit);
+		Terremesh::Cache::ResultCache cache(options[OptionIndex_Cache].arg != nullptr ? options[OptionIndex_Cache].arg : "");
+
+		if (options[OptionIndex_Cache].arg != nullptr)
+		{
+			processor.SetCache(&cache);
+		}
+
+		processor.SetSettings(settings);
+
+		int failed = processor.Process(jobs, &batchListener);
+
+		if (failed != 0)
+		{
+			std::cerr << failed << " of " << jobs.size() << " jobs failed" << std::endl;
+			return -1;
+		}
+
+		return 0;
+	}
+
 	if (options[OptionIndex_Input].arg == nullptr)
 	{
 		std::cerr << "No input specified" << std::endl;
@@ -125,6 +686,65 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
+	if (Terremesh::Remesh::MeshFile::GetFormat(options[OptionIndex_Output].arg) == Terremesh::Remesh::MeshFormat_Heightmap)
+	{
+		std::cerr << "Cannot write heightmap" << std::endl;
+		return -1;
+	}
+
+	if (options[OptionIndex_Replay].arg != nullptr)
+	{
+		Terremesh::IO::InputFileStream iStream(options[OptionIndex_Input].arg);
+		std::ifstream lStream(options[OptionIndex_Replay].arg, std::ios::in | std::ios::binary);
+
+		if (!lStream.is_open())
+		{
+			std::cerr << "Cannot open collapse log" << std::endl;
+			return -1;
+		}
+
+		ConsoleProgressListener listener;
+
+		Terremesh::Remesh::Mesh mesh;
+		Terremesh::Remesh::CollapseLogReader logReader(lStream);
+
+		auto format = Terremesh::Remesh::MeshFile::DetectFormat(iStream, options[OptionIndex_Input].arg);
+
+		if (!Terremesh::Remesh::MeshFile::Read(iStream, format, heightmap, mesh, &listener, &scheduler) || !iStream.Close())
+		{
+			std::cerr << "Cannot read input" << std::endl;
+			return -1;
+		}
+
+		// Log refers to vertices of preprocessed input
+		preprocessor.Process(mesh, &listener, &scheduler);
+
+		if (!logReader.Read(mesh, &listener))
+		{
+			std::cerr << "Cannot replay collapse log" << std::endl;
+			return -1;
+		}
+
+		if (optimizer != nullptr)
+		{
+			OptimizeVertexCache(*optimizer, mesh, &listener);
+		}
+
+		if (!Terremesh::Remesh::MeshFile::Write(mesh, options[OptionIndex_Output].arg, positionBits, &listener, &scheduler))
+		{
+			std::cerr << "Cannot write " << options[OptionIndex_Output].arg << std::endl;
+			return -1;
+		}
+
+		if ((meshletsFilePath != nullptr) && !WriteMeshlets(meshletBuilder, mesh, meshletsFilePath, &listener))
+		{
+			std::cerr << "Cannot write " << meshletsFilePath << std::endl;
+			return -1;
+		}
+
+		return 0;
+	}
+
 	if ((options[OptionIndex_Target].arg == nullptr) && (options[OptionIndex_Percent].arg == nullptr))
 	{
 		std::cerr << "No ratio or target specified" << std::endl;
@@ -139,48 +759,293 @@ int main(int argc, char* argv[])
 
 	const char* inputFilePath = options[OptionIndex_Input].arg;
 	const char* outputFilePath = options[OptionIndex_Output].arg;
-
+	const char* progressiveFilePath = options[OptionIndex_Progressive].arg;
+	const char* logFilePath = options[OptionIndex_Log].arg;
+	const char* cacheDirectory = options[OptionIndex_Cache].arg;
 	bool hasRatio = options[OptionIndex_Percent].arg != nullptr;
-	float ratio = 0.5;
-	int target = 2;
+	std::vector<double> ratios;
+	std::vector<size_t> targets;
 
 	if (hasRatio)
 	{
-		ratio = (double)atof(options[OptionIndex_Percent].arg);
+		ParseList(options[OptionIndex_Percent].arg, ratios);
 	}
 	else
 	{
-		target = atol(options[OptionIndex_Target].arg);
+		ParseList(options[OptionIndex_Target].arg, targets);
+	}
+
+	if (ratios.empty() && targets.empty())
+	{
+		std::cerr << "No ratio or target specified" << std::endl;
+		return -1;
+	}
+
+	if (Terremesh::IO::FilePath::IsStandardStream(outputFilePath) && (ratios.size() + targets.size() > 1))
+	{
+		std::cerr << "Cannot write levels of detail to standard output" << std::endl;
+		return -1;
 	}
 #else
+	PrintBanner();
 	
 	auto inputFilePath = "../canyon.obj";
 	auto outputFilePath = "../out.obj";
+	auto progressiveFilePath = (const char*)nullptr;
+	auto logFilePath = (const char*)nullptr;
+	auto buffersFilePath = (const char*)nullptr;
+	auto cacheDirectory = (const char*)nullptr;
+	auto methodName = "qem";
+	auto memoryless = false;
 	auto hasRatio = true;
-	auto ratio = 0.3;
-	auto target = 0;
+	auto ratios = std::vector<double>(1, 0.3);
+	auto targets = std::vector<size_t>();
+
+	auto areaWeights = false;
+	auto singlePrecision = false;
+	auto endpointPlacement = false;
+	auto indexWidth = 0;
+	Terremesh::Remesh::MeshPreprocessor preprocessor;
+	auto optimizer = (const Terremesh::Remesh::VertexCacheOptimizer*)nullptr;
+	auto meshletsFilePath = (const char*)nullptr;
+	auto positionBits = Terremesh::Remesh::MeshFile::DefaultPositionBits;
+	Terremesh::Remesh::MeshletBuilder meshletBuilder(64, 124);
+	Terremesh::Remesh::HeightmapOptions heightmap;
+	Terremesh::Batch::ConversionSettings settings;
+
+	Terremesh::Threading::TaskScheduler scheduler(0);
 #endif
 
-	std::ifstream iStream(inputFilePath);
-	std::ofstream oStream(outputFilePath);
+	Terremesh::IO::InputFileStream iStream(inputFilePath);
 
 	ConsoleProgressListener listener;
 
+	// Cache holds mesh files only, so it is bypassed when anything else is written
+	bool useCache = (cacheDirectory != nullptr) && (progressiveFilePath == nullptr) && (logFilePath == nullptr) && (buffersFilePath == nullptr) && (meshletsFilePath == nullptr) &&
+		!Terremesh::IO::FilePath::IsStandardStream(outputFilePath);
+
+	Terremesh::Cache::ResultCache cache(useCache ? cacheDirectory : "");
+	std::vector<std::pair<std::string, std::string> > cacheEntries;
+	std::vector<char> contents;
+
+	if (useCache)
+	{
+		// Input is hashed while read, so cache hit skips parsing
+		auto hash = Terremesh::Cache::ResultCache::ReadStream(iStream, contents);
+		auto values = hasRatio ? ratios : std::vector<double>(targets.begin(), targets.end());
+		auto key = Terremesh::Cache::ResultCache::MakeKey(hash,
+			Terremesh::Cache::ResultCache::FormatParameters(settings.Method, settings.FormatOptions(outputFilePath), hasRatio, values));
+
+		bool hit = true;
+
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			if (values.size() > 1)
+			{
+				std::ostringstream levelKey;
+				levelKey << key << ".lod" << i;
+				cacheEntries.push_back(std::make_pair(MakeLevelPath(outputFilePath, i), levelKey.str()));
+			}
+			else
+			{
+				cacheEntries.push_back(std::make_pair(std::string(outputFilePath), key));
+			}
+
+			hit = hit && cache.Contains(cacheEntries.back().second);
+		}
+
+		if (hit)
+		{
+			for (auto it = cacheEntries.begin(); it != cacheEntries.end(); ++it)
+			{
+				if (!cache.Fetch(it->second, it->first))
+				{
+					std::cerr << "Cannot write " << it->first << std::endl;
+					return -1;
+				}
+			}
+
+			std::cout << "Cache hit " << key << std::endl;
+			return 0;
+		}
+	}
+
+	Terremesh::IO::MemoryStreamBuffer contentsBuffer(contents.data(), contents.size());
+	std::istream contentsStream(&contentsBuffer);
+
 	Terremesh::Remesh::Mesh mesh;
-	Terremesh::Remesh::MeshReader reader(iStream);
-	Terremesh::Remesh::MeshWriter writer(oStream);
 
 	Terremesh::QuadricErrorMetric::QuadricErrorMetricMethod method;
-	reader.Read(mesh, &listener);
+	method.SetEnableAreaWeights(areaWeights);
+	method.SetEnableEndpointPlacement(endpointPlacement);
+	Terremesh::Memoryless::MemorylessMethod memorylessMethod;
+	memorylessMethod.SetEnableAreaWeights(areaWeights);
+	memorylessMethod.SetEnableEndpointPlacement(endpointPlacement);
+
+	auto& inputStream = useCache ? contentsStream : iStream;
+	auto inputFormat = Terremesh::Remesh::MeshFile::DetectFormat(inputStream, inputFilePath);
+
+	if (!Terremesh::Remesh::MeshFile::Read(inputStream, inputFormat, heightmap, mesh, &listener, &scheduler) || !iStream.Close())
+	{
+		std::cerr << "Cannot read input" << std::endl;
+		return -1;
+	}
+
+	preprocessor.Process(mesh, &listener, &scheduler);
+
+	CollapseListenerList collapseListeners;
+	Terremesh::ICollapseListener* collapseListener = nullptr;
+
+	// Progressive mesh is written relative to the input mesh
+	Terremesh::Remesh::Mesh inputMesh;
+	std::ofstream pStream;
+	Terremesh::Remesh::ProgressiveMeshWriter progressiveWriter(pStream);
+
+	if (progressiveFilePath != nullptr)
+	{
+		inputMesh = mesh;
+		pStream.open(progressiveFilePath, std::ios::out | std::ios::binary);
+
+		if (!pStream.is_open())
+		{
+			std::cerr << "Cannot write " << progressiveFilePath << std::endl;
+			return -1;
+		}
+
+		collapseListeners.Add(&progressiveWriter);
+		collapseListener = &collapseListeners;
+	}
+
+	std::ofstream lStream;
+	Terremesh::Remesh::CollapseLogWriter logWriter(lStream);
+
+	if (logFilePath != nullptr)
+	{
+		lStream.open(logFilePath, std::ios::out | std::ios::binary);
+
+		if (!lStream.is_open())
+		{
+			std::cerr << "Cannot write " << logFilePath << std::endl;
+			return -1;
+		}
+
+		logWriter.WriteHeader(mesh);
+		collapseListeners.Add(&logWriter);
+		collapseListener = &collapseListeners;
+	}
+
 	if (hasRatio)
 	{
-		method.Process(mesh, ratio, &listener);
+		for (auto it = ratios.begin(); it != ratios.end(); ++it)
+		{
+			targets.push_back((size_t)(*it * mesh.GetTriangles().size()));
+		}
 	}
-	else
+
+	bool smallIndices = Terremesh::QuadricErrorMetric::SmallQuadricErrorMetricContext::CanIndex(mesh);
+
+	if ((indexWidth == 16) && !smallIndices)
 	{
-		method.Process(mesh, target, &listener);
+		std::cerr << "Too many vertices for 16-bit indices" << std::endl;
+		return -1;
+	}
+
+	smallIndices = smallIndices && (indexWidth != 32);
+
+	auto process = [&](Terremesh::ISnapshotListener* snapshots)
+	{
+		if (memoryless)
+		{
+			Terremesh::Memoryless::MemorylessContext context;
+			context.SetCollapseListener(collapseListener);
+			memorylessMethod.Process(mesh, targets, context, snapshots, &listener, &scheduler);
+		}
+		else if (singlePrecision)
+		{
+			ProcessMesh<float>(method, mesh, targets, smallIndices, collapseListener, snapshots, &listener, &scheduler);
+		}
+		else
+		{
+			ProcessMesh<double>(method, mesh, targets, smallIndices, collapseListener, snapshots, &listener, &scheduler);
+		}
+	};
+
+	SnapshotListenerList snapshotListeners;
+	LevelOfDetailWriter levelWriter(outputFilePath, positionBits, optimizer, &listener, &scheduler);
+
+	std::ofstream bStream;
+	Terremesh::Remesh::LevelOfDetailBufferWriter buffersWriter(bStream);
+
+	if (targets.size() > 1)
+	{
+		// Generate all levels of detail in single pass
+		snapshotListeners.Add(&levelWriter);
+
+		if (meshletsFilePath != nullptr)
+		{
+			levelWriter.SetMeshlets(&meshletBuilder, meshletsFilePath);
+		}
+	}
+
+	if (buffersFilePath != nullptr)
+	{
+		bStream.open(buffersFilePath, std::ios::out | std::ios::binary);
+		buffersWriter.SetVertexCacheOptimizer(optimizer);
+		snapshotListeners.Add(&buffersWriter);
+	}
+
+	process(snapshotListeners.IsEmpty() ? nullptr : &snapshotListeners);
+
+	if (levelWriter.HasFailed())
+	{
+		return -1;
+	}
+
+	if ((logFilePath != nullptr) && !logWriter.Finish())
+	{
+		std::cerr << "Cannot write " << logFilePath << std::endl;
+		return -1;
+	}
+
+	if (targets.size() == 1)
+	{
+		if (optimizer != nullptr)
+		{
+			OptimizeVertexCache(*optimizer, mesh, &listener);
+		}
+
+		if (!Terremesh::Remesh::MeshFile::Write(mesh, outputFilePath, positionBits, &listener, &scheduler))
+		{
+			std::cerr << "Cannot write " << outputFilePath << std::endl;
+			return -1;
+		}
+
+		if ((meshletsFilePath != nullptr) && !WriteMeshlets(meshletBuilder, mesh, meshletsFilePath, &listener))
+		{
+			std::cerr << "Cannot write " << meshletsFilePath << std::endl;
+			return -1;
+		}
+	}
+
+	if ((buffersFilePath != nullptr) && !buffersWriter.Write(&listener))
+	{
+		std::cerr << "Levels of detail do not share vertices" << std::endl;
+		return -1;
+	}
+
+	if ((progressiveFilePath != nullptr) && !progressiveWriter.Write(inputMesh, &listener))
+	{
+		std::cerr << "Cannot write " << progressiveFilePath << std::endl;
+		return -1;
+	}
+
+	for (auto it = cacheEntries.begin(); it != cacheEntries.end(); ++it)
+	{
+		if (!cache.Store(it->second, it->first))
+		{
+			std::cerr << "Cannot store " << it->first << " in cache" << std::endl;
+		}
 	}
-	writer.Write(mesh, &listener);
 
 	return 0;
 }
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef _Terremesh_Batch_BatchJob_H__
+#define _Terremesh_Batch_BatchJob_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace Batch
+{
+	/// Describes single conversion processed in batch mode.
+	struct BatchJob
+	{
+	public:
+		/// Creates instance of the BatchJob structure.
+		BatchJob()
+			: HasRatio(true)
+			, Ratio(0.5)
+			, Target(2)
+		{
+		}
+
+		/// The input file path.
+		std::string InputPath;
+
+		/// The output file path.
+		std::string OutputPath;
+
+		/// Determines whether job uses ratio instead of target triangles count.
+		bool HasRatio;
+
+		/// The removed triangles ratio.
+		double Ratio;
+
+		/// The target number of triangles.
+		size_t Target;
+	};
+}
+}
+
+#endif /* _Terremesh_Batch_BatchJob_H__ */
@@ -0,0 +1,66 @@
+#include "BatchManifestReader.h"
+
+namespace Terremesh
+{
+namespace Batch
+{
+	BatchManifestReader::BatchManifestReader(std::istream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	bool BatchManifestReader::Read(std::vector<BatchJob>& jobs, const BatchJob& defaults)
+	{
+		std::string line;
+		int lineNumber = 0;
+
+		while (std::getline(m_Stream, line))
+		{
+			++lineNumber;
+
+			std::istringstream tokens(line);
+			std::string input;
+
+			// Skip empty lines and comments
+			if (!(tokens >> input) || input[0] == '#')
+			{
+				continue;
+			}
+
+			BatchJob job = defaults;
+			job.InputPath = input;
+
+			if (!(tokens >> job.OutputPath))
+			{
+				std::cerr << "Manifest line " << lineNumber << ": no output specified" << std::endl;
+				return false;
+			}
+
+			std::string option;
+
+			while (tokens >> option)
+			{
+				if (option.compare(0, 6, "ratio=") == 0)
+				{
+					job.HasRatio = true;
+					job.Ratio = atof(option.c_str() + 6);
+				}
+				else if (option.compare(0, 7, "target=") == 0)
+				{
+					job.HasRatio = false;
+					job.Target = (size_t)strtoull(option.c_str() + 7, nullptr, 10);
+				}
+				else
+				{
+					std::cerr << "Manifest line " << lineNumber << ": unknown option " << option << std::endl;
+					return false;
+				}
+			}
+
+			jobs.push_back(job);
+		}
+
+		return true;
+	}
+}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef _Terremesh_Batch_BatchManifestReader_H__
+#define _Terremesh_Batch_BatchManifestReader_H__
+
+#include "../Required.h"
+#include "BatchJob.h"
+
+namespace Terremesh
+{
+namespace Batch
+{
+	/// Implements batch manifest reader.
+	///
+	/// @remarks
+	///		Each non-empty line describes single job:
+	///
+	///			INPUT OUTPUT [ratio=RATIO|target=TRIANGLES]
+	///
+	///		Lines starting with '#' are ignored. Jobs without ratio or target
+	///		use values from default job.
+	class BatchManifestReader
+	{
+	public:
+		/// Creates instance of the BatchManifestReader class.
+		///
+		/// @param[in] stream
+		///		The input stream.
+		BatchManifestReader(std::istream& stream);
+
+		/// Reads jobs from stream.
+		///
+		/// @param[out] jobs
+		///		The jobs.
+		/// @param[in] defaults
+		///		The default job settings.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Read(std::vector<BatchJob>& jobs, const BatchJob& defaults);
+
+	private:
+		BatchManifestReader(const BatchManifestReader&);
+		BatchManifestReader& operator = (const BatchManifestReader&);
+
+		std::istream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Batch_BatchManifestReader_H__ */
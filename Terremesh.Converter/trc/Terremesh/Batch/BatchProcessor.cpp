@@ -0,0 +1,331 @@
+#include "BatchProcessor.h"
+#include "../Remesh/MeshFile.h"
+#include "../IO/MemoryStreamBuffer.h"
+#include "../IO/FileStream.h"
+
+namespace Terremesh
+{
+namespace Batch
+{
+	/// Approximate ratio of in-memory mesh size to .obj file size.
+	static const size_t MemoryPerInputByte = 16;
+
+	/// Approximate ratio of .obj file size to its .gz or .zst size.
+	static const size_t CompressionRatio = 4;
+
+	BatchProcessor::BatchProcessor(Threading::TaskScheduler& scheduler, int workers, size_t memoryLimit)
+		: m_Scheduler(scheduler)
+		, m_Workers(workers)
+		, m_Budget(memoryLimit)
+		, m_Cache(nullptr)
+		, m_Jobs(nullptr)
+		, m_Group(nullptr)
+		, m_Next(0)
+		, m_Running(0)
+		, m_Completed(0)
+		, m_Failed(0)
+		, m_Listener(nullptr)
+	{
+		if (m_Workers <= 0)
+		{
+			m_Workers = m_Scheduler.GetThreadCount();
+		}
+	}
+
+	void BatchProcessor::SetSettings(const ConversionSettings& value)
+	{
+		m_Settings = value;
+
+		m_Method.SetEnableAreaWeights(value.AreaWeights);
+		m_Method.SetEnableEndpointPlacement(value.EndpointPlacement);
+		m_MemorylessMethod.SetEnableAreaWeights(value.AreaWeights);
+		m_MemorylessMethod.SetEnableEndpointPlacement(value.EndpointPlacement);
+	}
+
+	int BatchProcessor::Process(const std::vector<BatchJob>& jobs, IProgressListener* listener)
+	{
+		m_Jobs = &jobs;
+		m_Listener = listener;
+		m_Next = 0;
+		m_Completed = 0;
+		m_Failed = 0;
+
+		// Schedule largest inputs first, so the tail of the batch is short
+		m_Order.clear();
+
+		for (size_t i = 0; i < jobs.size(); ++i)
+		{
+			m_Order.push_back(std::make_pair(EstimateMemory(jobs[i].InputPath), i));
+		}
+
+		std::stable_sort(m_Order.begin(), m_Order.end(),
+			[](const std::pair<size_t, size_t>& lhs, const std::pair<size_t, size_t>& rhs)
+			{
+				return lhs.first > rhs.first;
+			});
+
+		if (m_Listener != nullptr)
+		{
+			m_Listener->OnStarted("Batch");
+		}
+
+		// Finished jobs return their states here, so growing it never fails
+		m_Idle.reserve((size_t)m_Workers);
+
+		Threading::TaskGroup group;
+		m_Group = &group;
+		m_Running = 0;
+
+		// Dispatch runs as task of group, so its failure is rethrown after queued jobs
+		m_Scheduler.Run(group, [this]()
+		{
+			Dispatch();
+		});
+
+		m_Scheduler.Wait(group);
+
+		if (m_Listener != nullptr)
+		{
+			m_Listener->OnCompleted("Batch");
+		}
+
+		m_Jobs = nullptr;
+		m_Group = nullptr;
+		m_Listener = nullptr;
+		m_Idle.clear();
+
+		return m_Failed;
+	}
+
+	void BatchProcessor::Dispatch()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Budget is acquired before queuing, so waiting jobs hold no pool thread
+		while ((m_Running < m_Workers) && (m_Next < m_Order.size()))
+		{
+			size_t index = m_Next;
+			size_t acquired;
+
+			if (!m_Budget.TryAcquire(m_Order[index].first, acquired))
+			{
+				break;
+			}
+
+			try
+			{
+				m_Scheduler.Run(*m_Group, [this, index, acquired]()
+				{
+					Work(index, acquired);
+				});
+			}
+			catch (...)
+			{
+				m_Budget.Release(acquired);
+				throw;
+			}
+
+			++m_Next;
+			++m_Running;
+		}
+	}
+
+	void BatchProcessor::Work(size_t index, size_t acquired)
+	{
+		const BatchJob& job = (*m_Jobs)[m_Order[index].second];
+
+		// States are reused between jobs
+		std::unique_ptr<Worker> worker;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (!m_Idle.empty())
+			{
+				worker = std::move(m_Idle.back());
+				m_Idle.pop_back();
+			}
+		}
+
+		bool succeeded = false;
+
+		try
+		{
+			if (worker == nullptr)
+			{
+				worker.reset(new Worker());
+			}
+
+			succeeded = ProcessJob(job, *worker);
+		}
+		catch (const std::bad_alloc&)
+		{
+			// State left by failed job is dropped to give memory back
+			worker.reset();
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			std::cerr << "Out of memory converting " << job.InputPath << std::endl;
+		}
+		catch (const std::exception& exception)
+		{
+			worker.reset();
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			std::cerr << "Error converting " << job.InputPath << ": " << exception.what() << std::endl;
+		}
+
+		m_Budget.Release(acquired);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (worker != nullptr)
+			{
+				m_Idle.push_back(std::move(worker));
+			}
+
+			--m_Running;
+			++m_Completed;
+
+			if (!succeeded)
+			{
+				++m_Failed;
+				std::cerr << "Cannot convert " << job.InputPath << " to " << job.OutputPath << std::endl;
+			}
+
+			if (m_Listener != nullptr)
+			{
+				m_Listener->OnStep(m_Completed, (int)m_Order.size());
+			}
+		}
+
+		Dispatch();
+	}
+
+	template <typename TContext, typename TSmallContext>
+	bool BatchProcessor::Simplify(Remesh::Mesh& mesh, const std::vector<size_t>& targets, TContext& context, TSmallContext& smallContext)
+	{
+		bool smallIndices = QuadricErrorMetric::SmallQuadricErrorMetricContext::CanIndex(mesh);
+
+		if ((m_Settings.IndexWidth == 16) && !smallIndices)
+		{
+			return false;
+		}
+
+		// Small tiles use 16-bit indices
+		if (smallIndices && (m_Settings.IndexWidth != 32))
+		{
+			m_Method.Process(mesh, targets, smallContext, nullptr, nullptr, &m_Scheduler);
+		}
+		else
+		{
+			m_Method.Process(mesh, targets, context, nullptr, nullptr, &m_Scheduler);
+		}
+
+		return true;
+	}
+
+	bool BatchProcessor::ProcessJob(const BatchJob& job, Worker& worker)
+	{
+		IO::InputFileStream iStream(job.InputPath);
+
+		if (!iStream.IsOpen())
+		{
+			return false;
+		}
+
+		std::vector<char> contents;
+		std::string key;
+
+		if (m_Cache != nullptr)
+		{
+			// Input is hashed while read, so cache hit skips parsing
+			auto hash = Cache::ResultCache::ReadStream(iStream, contents);
+			auto values = std::vector<double>(1, job.HasRatio ? job.Ratio : (double)job.Target);
+
+			key = Cache::ResultCache::MakeKey(hash,
+				Cache::ResultCache::FormatParameters(m_Settings.Method, m_Settings.FormatOptions(job.OutputPath), job.HasRatio, values));
+
+			if (m_Cache->Contains(key))
+			{
+				return m_Cache->Fetch(key, job.OutputPath);
+			}
+		}
+
+		IO::MemoryStreamBuffer contentsBuffer(contents.data(), contents.size());
+		std::istream contentsStream(&contentsBuffer);
+
+		auto& mesh = worker.Mesh;
+		auto& inputStream = (m_Cache != nullptr) ? contentsStream : iStream;
+		auto format = Remesh::MeshFile::DetectFormat(inputStream, job.InputPath);
+		bool read = Remesh::MeshFile::Read(inputStream, format, m_Settings.Heightmap, mesh, nullptr, &m_Scheduler);
+		read = iStream.Close() && read;
+
+		if (!read)
+		{
+			mesh.Clear();
+			return false;
+		}
+
+		m_Settings.Preprocessor.Process(mesh, nullptr, &m_Scheduler);
+
+		size_t target = job.HasRatio ? (size_t)(job.Ratio * mesh.GetTriangles().size()) : job.Target;
+		std::vector<size_t> targets(1, target);
+		bool remeshed = true;
+
+		if (m_Settings.Method == "memoryless")
+		{
+			m_MemorylessMethod.Process(mesh, targets, worker.MemorylessContext, nullptr, nullptr, &m_Scheduler);
+		}
+		else if (m_Settings.SinglePrecision)
+		{
+			remeshed = Simplify(mesh, targets, worker.FloatContext, worker.SmallFloatContext);
+		}
+		else
+		{
+			remeshed = Simplify(mesh, targets, worker.Context, worker.SmallContext);
+		}
+
+		if (!remeshed)
+		{
+			mesh.Clear();
+			return false;
+		}
+
+		if (m_Settings.Optimizer != nullptr)
+		{
+			m_Settings.Optimizer->Optimize(mesh, nullptr);
+		}
+
+		bool written = Remesh::MeshFile::Write(mesh, job.OutputPath, m_Settings.PositionBits, nullptr, &m_Scheduler);
+		mesh.Clear();
+
+		if (!written)
+		{
+			return false;
+		}
+
+		if ((m_Cache != nullptr) && !m_Cache->Store(key, job.OutputPath))
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			std::cerr << "Cannot store " << job.OutputPath << " in cache" << std::endl;
+		}
+
+		return true;
+	}
+
+	size_t BatchProcessor::EstimateMemory(const std::string& path)
+	{
+		std::ifstream stream(path.c_str(), std::ios::binary | std::ios::ate);
+
+		if (!stream.is_open())
+		{
+			return 0;
+		}
+
+		size_t size = (size_t)stream.tellg() * MemoryPerInputByte;
+
+		return (IO::FilePath::GetCompression(path) != IO::Compression_None) ? size * CompressionRatio : size;
+	}
+}
+}
@@ -0,0 +1,196 @@
+#pragma once
+#ifndef _Terremesh_Batch_BatchProcessor_H__
+#define _Terremesh_Batch_BatchProcessor_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "../Remesh/Mesh.h"
+#include "../QuadricErrorMetric/QuadricErrorMetricMethod.h"
+#include "../Memoryless/MemorylessMethod.h"
+#include "../Cache/ResultCache.h"
+#include "../Threading/TaskScheduler.h"
+#include "BatchJob.h"
+#include "ConversionSettings.h"
+#include "MemoryBudget.h"
+
+namespace Terremesh
+{
+namespace Batch
+{
+	/// Implements concurrent processing of many conversion jobs.
+	///
+	/// @remarks
+	///		Jobs run as tasks of shared scheduler, largest inputs first, at
+	///		most one per worker. Job is queued only once memory budget allows
+	///		it, and each completed job queues following ones, so no pool
+	///		thread waits for memory. Workers share single method instance.
+	///		Each worker owns mesh and method contexts, which are reused
+	///		between its jobs. Parallel parts of jobs run on the same
+	///		scheduler, using threads left idle by workers. Exceptions of
+	///		parallel parts are rethrown on thread of their job, so job
+	///		running out of memory or failing otherwise fails alone.
+	class BatchProcessor
+	{
+	public:
+		/// Creates instance of the BatchProcessor class.
+		///
+		/// @param[in] scheduler
+		///		The scheduler running workers and parallel parts of jobs.
+		/// @param[in] workers
+		///		The number of workers. Zero selects scheduler thread count.
+		/// @param[in] memoryLimit
+		///		The memory budget in bytes. Zero means unlimited budget.
+		BatchProcessor(Threading::TaskScheduler& scheduler, int workers, size_t memoryLimit);
+
+		/// Processes jobs.
+		///
+		/// @param[in] jobs
+		///		The jobs to process.
+		/// @param[in] listener
+		///		The progress listener, advanced once per completed job.
+		///
+		/// @return
+		///		The number of failed jobs.
+		int Process(const std::vector<BatchJob>& jobs, IProgressListener* listener);
+
+		/// Gets result cache.
+		///
+		/// @return
+		///		The result cache or nullptr.
+		const Cache::ResultCache* GetCache() const { return m_Cache; }
+
+		/// Sets result cache used by jobs.
+		///
+		/// @param[in] value
+		///		The result cache or nullptr.
+		void SetCache(const Cache::ResultCache* value) { m_Cache = value; }
+
+		/// Gets conversion applied to all jobs.
+		///
+		/// @return
+		///		The conversion settings.
+		const ConversionSettings& GetSettings() const { return m_Settings; }
+
+		/// Sets conversion applied to all jobs.
+		///
+		/// @param[in] value
+		///		The conversion settings.
+		void SetSettings(const ConversionSettings& value);
+
+	private:
+		BatchProcessor(const BatchProcessor&);
+		BatchProcessor& operator = (const BatchProcessor&);
+
+		/// Holds state owned by single worker.
+		struct Worker
+		{
+			Remesh::Mesh Mesh;
+			QuadricErrorMetric::QuadricErrorMetricContext Context;
+			QuadricErrorMetric::SmallQuadricErrorMetricContext SmallContext;
+			QuadricErrorMetric::FloatQuadricErrorMetricContext FloatContext;
+			QuadricErrorMetric::BasicQuadricErrorMetricContext<float, unsigned short> SmallFloatContext;
+			Memoryless::MemorylessContext MemorylessContext;
+		};
+
+		/// Queues following jobs while workers are free and memory budget allows.
+		void Dispatch();
+
+		/// Runs single job and queues following ones.
+		///
+		/// @param[in] index
+		///		The index of job in processing order.
+		/// @param[in] acquired
+		///		The memory acquired from budget for job.
+		void Work(size_t index, size_t acquired);
+
+		/// Processes single job.
+		///
+		/// @param[in] job
+		///		The job.
+		/// @param[in,out] worker
+		///		The worker state.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool ProcessJob(const BatchJob& job, Worker& worker);
+
+		/// Remeshes mesh using context of chosen storage precision.
+		///
+		/// @param[in,out] mesh
+		///		The mesh.
+		/// @param[in] targets
+		///		The target triangles counts.
+		/// @param[in,out] context
+		///		The context of meshes indexed by 32 bits.
+		/// @param[in,out] smallContext
+		///		The context of meshes indexed by 16 bits.
+		///
+		/// @retval true when successful.
+		/// @retval false when mesh cannot be indexed by requested width.
+		template <typename TContext, typename TSmallContext>
+		bool Simplify(Remesh::Mesh& mesh, const std::vector<size_t>& targets, TContext& context, TSmallContext& smallContext);
+
+		/// Estimates memory required to process input file.
+		///
+		/// @param[in] path
+		///		The input file path.
+		///
+		/// @return
+		///		The estimated number of bytes.
+		static size_t EstimateMemory(const std::string& path);
+
+		/// The scheduler.
+		Threading::TaskScheduler& m_Scheduler;
+
+		/// The number of workers.
+		int m_Workers;
+
+		/// The memory budget.
+		MemoryBudget m_Budget;
+
+		/// The method shared by workers.
+		QuadricErrorMetric::QuadricErrorMetricMethod m_Method;
+
+		/// The memoryless method shared by workers.
+		Memoryless::MemorylessMethod m_MemorylessMethod;
+
+		/// The result cache.
+		const Cache::ResultCache* m_Cache;
+
+		/// The conversion applied to all jobs.
+		ConversionSettings m_Settings;
+
+		/// The processed jobs.
+		const std::vector<BatchJob>* m_Jobs;
+
+		/// The job processing order.
+		std::vector<std::pair<size_t, size_t> > m_Order;
+
+		/// The group of queued jobs.
+		Threading::TaskGroup* m_Group;
+
+		/// The next job to process.
+		size_t m_Next;
+
+		/// The number of running jobs.
+		int m_Running;
+
+		/// The states of workers not running any job.
+		std::vector<std::unique_ptr<Worker> > m_Idle;
+
+		/// The number of completed jobs.
+		int m_Completed;
+
+		/// The number of failed jobs.
+		int m_Failed;
+
+		/// The progress listener.
+		IProgressListener* m_Listener;
+
+		/// The mutex guarding job dispatch and progress reporting.
+		std::mutex m_Mutex;
+	};
+}
+}
+
+#endif /* _Terremesh_Batch_BatchProcessor_H__ */
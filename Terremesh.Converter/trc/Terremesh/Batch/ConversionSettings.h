@@ -0,0 +1,111 @@
+#pragma once
+#ifndef _Terremesh_Batch_ConversionSettings_H__
+#define _Terremesh_Batch_ConversionSettings_H__
+
+#include "../Required.h"
+#include "../Remesh/MeshFile.h"
+#include "../Remesh/MeshPreprocessor.h"
+#include "../Remesh/HeightmapReader.h"
+#include "../Remesh/VertexCacheOptimizer.h"
+
+namespace Terremesh
+{
+namespace Batch
+{
+	/// Describes conversion applied to input meshes.
+	struct ConversionSettings
+	{
+	public:
+		/// Creates instance of the ConversionSettings structure.
+		ConversionSettings()
+			: Method("qem")
+			, AreaWeights(false)
+			, SinglePrecision(false)
+			, EndpointPlacement(false)
+			, IndexWidth(0)
+			, Optimizer(nullptr)
+			, PositionBits(Remesh::MeshFile::DefaultPositionBits)
+		{
+		}
+
+		/// The method name, "qem" or "memoryless".
+		std::string Method;
+
+		/// The stages applied to inputs after reading.
+		Remesh::MeshPreprocessor Preprocessor;
+
+		/// Determines whether plane quadrics are weighted by triangle area.
+		bool AreaWeights;
+
+		/// Determines whether quadric error metric uses float storage.
+		bool SinglePrecision;
+
+		/// Determines whether merged vertex is placed at one of edge endpoints.
+		bool EndpointPlacement;
+
+		/// The index width of quadric error metric, 16, 32 or 0 for automatic.
+		int IndexWidth;
+
+		/// The vertex cache optimizer of outputs or nullptr.
+		const Remesh::VertexCacheOptimizer* Optimizer;
+
+		/// The number of bits per coordinate of compressed output.
+		unsigned int PositionBits;
+
+		/// The placement of heightmap inputs.
+		Remesh::HeightmapOptions Heightmap;
+
+		/// Formats settings as result cache options.
+		///
+		/// @param[in] outputPath
+		///		The output file path, whose format is part of options.
+		///
+		/// @return
+		///		The options, empty for default settings.
+		std::string FormatOptions(const std::string& outputPath) const
+		{
+			std::vector<std::string> items;
+			items.push_back(Preprocessor.FormatOptions());
+
+			if (AreaWeights)
+			{
+				items.push_back("weights=area");
+			}
+
+			if (SinglePrecision)
+			{
+				items.push_back("precision=float");
+			}
+
+			if (EndpointPlacement)
+			{
+				items.push_back("placement=endpoint");
+			}
+
+			if (Optimizer != nullptr)
+			{
+				std::ostringstream option;
+				option << "vertex-cache=" << Optimizer->GetCacheSize();
+				items.push_back(option.str());
+			}
+
+			items.push_back(Heightmap.FormatOptions());
+			items.push_back(Remesh::MeshFile::FormatOptions(outputPath, PositionBits));
+
+			std::string options;
+
+			for (auto it = items.begin(); it != items.end(); ++it)
+			{
+				if (!it->empty())
+				{
+					options += (options.empty() ? "" : ";") + *it;
+				}
+			}
+
+			return options;
+		}
+	};
+}
+}
+
+#endif /* _Terremesh_Batch_ConversionSettings_H__ */
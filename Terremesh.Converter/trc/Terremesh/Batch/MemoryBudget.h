@@ -0,0 +1,96 @@
+#pragma once
+#ifndef _Terremesh_Batch_MemoryBudget_H__
+#define _Terremesh_Batch_MemoryBudget_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace Batch
+{
+	/// Implements memory budget shared by concurrently running jobs.
+	///
+	/// @remarks
+	///		Job larger than whole budget is clamped to it, so it runs alone.
+	///		Budget never blocks, caller starts job later when memory is
+	///		not available.
+	class MemoryBudget
+	{
+	public:
+		/// Creates instance of the MemoryBudget class.
+		///
+		/// @param[in] limit
+		///		The budget in bytes. Zero means unlimited budget.
+		MemoryBudget(size_t limit)
+			: m_Limit(limit)
+			, m_Used(0)
+		{
+		}
+
+		/// Acquires memory from budget when it is available.
+		///
+		/// @param[in] size
+		///		The requested number of bytes.
+		/// @param[out] acquired
+		///		The acquired number of bytes, which must be passed to Release.
+		///
+		/// @retval true when memory was acquired.
+		/// @retval false when budget is exhausted.
+		bool TryAcquire(size_t size, size_t& acquired)
+		{
+			acquired = 0;
+
+			if (m_Limit == 0)
+			{
+				return true;
+			}
+
+			if (size > m_Limit)
+			{
+				size = m_Limit;
+			}
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (m_Used + size > m_Limit)
+			{
+				return false;
+			}
+
+			m_Used += size;
+			acquired = size;
+			return true;
+		}
+
+		/// Releases memory back to budget.
+		///
+		/// @param[in] size
+		///		The number of bytes acquired by TryAcquire.
+		void Release(size_t size)
+		{
+			if (m_Limit == 0)
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Used -= size;
+		}
+
+	private:
+		MemoryBudget(const MemoryBudget&);
+		MemoryBudget& operator = (const MemoryBudget&);
+
+		/// The budget limit.
+		size_t m_Limit;
+
+		/// The used memory.
+		size_t m_Used;
+
+		/// The budget mutex.
+		std::mutex m_Mutex;
+	};
+}
+}
+
+#endif /* _Terremesh_Batch_MemoryBudget_H__ */
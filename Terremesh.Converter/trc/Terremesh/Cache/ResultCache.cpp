@@ -0,0 +1,132 @@
+#include "ResultCache.h"
+#include "XXHash64.h"
+
+#include <cstdio>
+
+namespace Terremesh
+{
+namespace Cache
+{
+	/// Version of cached results, mixed into all keys.
+	static const char* CacheVersion = "trc-cache-1";
+
+	/// Size of chunks in which input is read and hashed.
+	static const size_t ReadChunkSize = 1 << 20;
+
+	ResultCache::ResultCache(const std::string& directory)
+		: m_Directory(directory)
+	{
+	}
+
+	unsigned long long ResultCache::ReadStream(std::istream& stream, std::vector<char>& contents)
+	{
+		XXHash64 hash;
+
+		contents.clear();
+
+		for (;;)
+		{
+			size_t offset = contents.size();
+			contents.resize(offset + ReadChunkSize);
+
+			stream.read(&contents[offset], ReadChunkSize);
+			size_t count = (size_t)stream.gcount();
+
+			contents.resize(offset + count);
+			hash.Update(contents.data() + offset, count);
+
+			if (count < ReadChunkSize)
+			{
+				break;
+			}
+		}
+
+		return hash.Finish();
+	}
+
+	std::string ResultCache::FormatParameters(const std::string& method, const std::string& options, bool hasRatio, const std::vector<double>& values)
+	{
+		std::ostringstream parameters;
+		parameters.precision(17);
+		parameters << CacheVersion << ";method=" << method << (options.empty() ? "" : ";") << options << (hasRatio ? ";ratio=" : ";target=");
+
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			parameters << (i == 0 ? "" : ",") << values[i];
+		}
+
+		return parameters.str();
+	}
+
+	std::string ResultCache::MakeKey(unsigned long long inputHash, const std::string& parameters)
+	{
+		unsigned long long parametersHash = XXHash64::Compute(parameters.data(), parameters.size(), inputHash);
+
+		char key[33];
+		sprintf(key, "%016llx%016llx", inputHash, parametersHash);
+
+		return key;
+	}
+
+	bool ResultCache::Fetch(const std::string& key, const std::string& outputPath) const
+	{
+		return CopyContents(GetPath(key), outputPath);
+	}
+
+	bool ResultCache::Contains(const std::string& key) const
+	{
+		std::ifstream stream(GetPath(key).c_str());
+		return stream.is_open();
+	}
+
+	bool ResultCache::Store(const std::string& key, const std::string& outputPath) const
+	{
+		std::ostringstream temporaryPath;
+		temporaryPath << GetPath(key) << "." << std::this_thread::get_id() << "." << clock() << ".tmp";
+
+		if (!CopyContents(outputPath, temporaryPath.str()))
+		{
+			remove(temporaryPath.str().c_str());
+			return false;
+		}
+
+		// Entry may have been stored concurrently by another process
+		if (rename(temporaryPath.str().c_str(), GetPath(key).c_str()) != 0)
+		{
+			remove(temporaryPath.str().c_str());
+			return Contains(key);
+		}
+
+		return true;
+	}
+
+	std::string ResultCache::GetPath(const std::string& key) const
+	{
+		return m_Directory + "/" + key + ".obj";
+	}
+
+	bool ResultCache::CopyContents(const std::string& sourcePath, const std::string& targetPath)
+	{
+		std::ifstream source(sourcePath.c_str(), std::ios::in | std::ios::binary);
+
+		if (!source.is_open())
+		{
+			return false;
+		}
+
+		std::ofstream target(targetPath.c_str(), std::ios::out | std::ios::binary);
+
+		if (!target.is_open())
+		{
+			return false;
+		}
+
+		if (source.peek() != std::char_traits<char>::eof())
+		{
+			target << source.rdbuf();
+		}
+
+		return target.good();
+	}
+}
+}
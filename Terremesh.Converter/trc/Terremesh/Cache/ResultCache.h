@@ -0,0 +1,107 @@
+#pragma once
+#ifndef _Terremesh_Cache_ResultCache_H__
+#define _Terremesh_Cache_ResultCache_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace Cache
+{
+	/// Implements on-disk cache of conversion results.
+	///
+	/// @remarks
+	///		Entries are keyed by hash of input file contents and conversion
+	///		parameters and stored as files in cache directory. Entries are
+	///		stored atomically, so cache may be shared by concurrent processes.
+	class ResultCache
+	{
+	public:
+		/// Creates instance of the ResultCache class.
+		///
+		/// @param[in] directory
+		///		The existing cache directory.
+		ResultCache(const std::string& directory);
+
+		/// Reads whole stream into memory, hashing it while reading.
+		///
+		/// @param[in] stream
+		///		The input stream.
+		/// @param[out] contents
+		///		The stream contents.
+		///
+		/// @return
+		///		The contents hash.
+		static unsigned long long ReadStream(std::istream& stream, std::vector<char>& contents);
+
+		/// Formats conversion parameters.
+		///
+		/// @param[in] method
+		///		The method name.
+		/// @param[in] options
+		///		The other options affecting result, as ';' separated NAME=VALUE items.
+		/// @param[in] hasRatio
+		///		Determines whether values are ratios or target triangle counts.
+		/// @param[in] values
+		///		The ratios or target triangle counts.
+		///
+		/// @return
+		///		The parameters string.
+		static std::string FormatParameters(const std::string& method, const std::string& options, bool hasRatio, const std::vector<double>& values);
+
+		/// Makes entry key.
+		///
+		/// @param[in] inputHash
+		///		The input contents hash.
+		/// @param[in] parameters
+		///		The conversion parameters.
+		///
+		/// @return
+		///		The entry key.
+		static std::string MakeKey(unsigned long long inputHash, const std::string& parameters);
+
+		/// Copies cached entry into output file.
+		///
+		/// @param[in] key
+		///		The entry key.
+		/// @param[in] outputPath
+		///		The output file path.
+		///
+		/// @retval true when entry was found and copied.
+		/// @retval false otherwise.
+		bool Fetch(const std::string& key, const std::string& outputPath) const;
+
+		/// Determines whether entry is present.
+		///
+		/// @param[in] key
+		///		The entry key.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Contains(const std::string& key) const;
+
+		/// Stores output file as cache entry.
+		///
+		/// @param[in] key
+		///		The entry key.
+		/// @param[in] outputPath
+		///		The output file path.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Store(const std::string& key, const std::string& outputPath) const;
+
+	private:
+		/// Gets entry file path.
+		std::string GetPath(const std::string& key) const;
+
+		/// Copies file.
+		static bool CopyContents(const std::string& sourcePath, const std::string& targetPath);
+
+		/// The cache directory.
+		std::string m_Directory;
+	};
+}
+}
+
+#endif /* _Terremesh_Cache_ResultCache_H__ */
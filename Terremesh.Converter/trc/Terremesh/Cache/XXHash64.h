@@ -0,0 +1,214 @@
+#pragma once
+#ifndef _Terremesh_Cache_XXHash64_H__
+#define _Terremesh_Cache_XXHash64_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace Cache
+{
+	/// Implements streaming xxHash64 hash function.
+	class XXHash64
+	{
+	public:
+		/// Creates instance of the XXHash64 class.
+		///
+		/// @param[in] seed
+		///		The hash seed.
+		XXHash64(unsigned long long seed = 0)
+			: m_TotalLength(0)
+			, m_BufferSize(0)
+		{
+			m_State[0] = seed + Prime1 + Prime2;
+			m_State[1] = seed + Prime2;
+			m_State[2] = seed;
+			m_State[3] = seed - Prime1;
+			m_Seed = seed;
+		}
+
+		/// Hashes data.
+		///
+		/// @param[in] data
+		///		The data.
+		/// @param[in] length
+		///		The data length in bytes.
+		void Update(const void* data, size_t length)
+		{
+			const unsigned char* input = static_cast<const unsigned char*>(data);
+			const unsigned char* end = input + length;
+
+			m_TotalLength += length;
+
+			// Complete buffered stripe
+			if (m_BufferSize != 0)
+			{
+				while ((m_BufferSize < 32) && (input != end))
+				{
+					m_Buffer[m_BufferSize++] = *input++;
+				}
+
+				if (m_BufferSize < 32)
+				{
+					return;
+				}
+
+				ProcessStripe(m_Buffer);
+				m_BufferSize = 0;
+			}
+
+			while (end - input >= 32)
+			{
+				ProcessStripe(input);
+				input += 32;
+			}
+
+			while (input != end)
+			{
+				m_Buffer[m_BufferSize++] = *input++;
+			}
+		}
+
+		/// Computes hash of all data.
+		///
+		/// @return
+		///		The hash value.
+		unsigned long long Finish() const
+		{
+			unsigned long long hash;
+
+			if (m_TotalLength >= 32)
+			{
+				hash = Rotate(m_State[0], 1) + Rotate(m_State[1], 7) + Rotate(m_State[2], 12) + Rotate(m_State[3], 18);
+				hash = MergeRound(hash, m_State[0]);
+				hash = MergeRound(hash, m_State[1]);
+				hash = MergeRound(hash, m_State[2]);
+				hash = MergeRound(hash, m_State[3]);
+			}
+			else
+			{
+				hash = m_Seed + Prime5;
+			}
+
+			hash += m_TotalLength;
+
+			const unsigned char* input = m_Buffer;
+			const unsigned char* end = m_Buffer + m_BufferSize;
+
+			while (end - input >= 8)
+			{
+				hash ^= Round(0, Read64(input));
+				hash = Rotate(hash, 27) * Prime1 + Prime4;
+				input += 8;
+			}
+
+			if (end - input >= 4)
+			{
+				hash ^= (unsigned long long)Read32(input) * Prime1;
+				hash = Rotate(hash, 23) * Prime2 + Prime3;
+				input += 4;
+			}
+
+			while (input != end)
+			{
+				hash ^= (*input++) * Prime5;
+				hash = Rotate(hash, 11) * Prime1;
+			}
+
+			hash ^= hash >> 33;
+			hash *= Prime2;
+			hash ^= hash >> 29;
+			hash *= Prime3;
+			hash ^= hash >> 32;
+
+			return hash;
+		}
+
+		/// Computes hash of data.
+		///
+		/// @param[in] data
+		///		The data.
+		/// @param[in] length
+		///		The data length in bytes.
+		/// @param[in] seed
+		///		The hash seed.
+		///
+		/// @return
+		///		The hash value.
+		static unsigned long long Compute(const void* data, size_t length, unsigned long long seed = 0)
+		{
+			XXHash64 hash(seed);
+			hash.Update(data, length);
+			return hash.Finish();
+		}
+
+	private:
+		static const unsigned long long Prime1 = 11400714785074694791ULL;
+		static const unsigned long long Prime2 = 14029467366897019727ULL;
+		static const unsigned long long Prime3 = 1609587929392839161ULL;
+		static const unsigned long long Prime4 = 9650029242287828579ULL;
+		static const unsigned long long Prime5 = 2870177450012600261ULL;
+
+		static unsigned long long Rotate(unsigned long long value, int bits)
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		static unsigned long long Round(unsigned long long accumulator, unsigned long long input)
+		{
+			accumulator += input * Prime2;
+			accumulator = Rotate(accumulator, 31);
+			return accumulator * Prime1;
+		}
+
+		static unsigned long long MergeRound(unsigned long long accumulator, unsigned long long value)
+		{
+			accumulator ^= Round(0, value);
+			return accumulator * Prime1 + Prime4;
+		}
+
+		static unsigned long long Read64(const unsigned char* input)
+		{
+			unsigned long long value = 0;
+
+			for (int i = 7; i >= 0; --i)
+			{
+				value = (value << 8) | input[i];
+			}
+
+			return value;
+		}
+
+		static unsigned int Read32(const unsigned char* input)
+		{
+			return (unsigned int)input[0] | ((unsigned int)input[1] << 8) |
+				((unsigned int)input[2] << 16) | ((unsigned int)input[3] << 24);
+		}
+
+		void ProcessStripe(const unsigned char* input)
+		{
+			m_State[0] = Round(m_State[0], Read64(input));
+			m_State[1] = Round(m_State[1], Read64(input + 8));
+			m_State[2] = Round(m_State[2], Read64(input + 16));
+			m_State[3] = Round(m_State[3], Read64(input + 24));
+		}
+
+		/// The accumulators.
+		unsigned long long m_State[4];
+
+		/// The seed.
+		unsigned long long m_Seed;
+
+		/// The number of hashed bytes.
+		unsigned long long m_TotalLength;
+
+		/// The incomplete stripe.
+		unsigned char m_Buffer[32];
+
+		/// The incomplete stripe size.
+		size_t m_BufferSize;
+	};
+}
+}
+
+#endif /* _Terremesh_Cache_XXHash64_H__ */
@@ -0,0 +1,23 @@
+#pragma once
+#ifndef _Terremesh_ICollapseListener_H__
+#define _Terremesh_ICollapseListener_H__
+
+#include "Required.h"
+#include "Remesh/EdgeCollapse.h"
+
+namespace Terremesh
+{
+	/// Provides interface for receiving collapses performed by remeshing method.
+	struct ICollapseListener
+	{
+		virtual ~ICollapseListener() {}
+
+		/// Receives collapse.
+		///
+		/// @param[in] collapse
+		///		The performed collapse.
+		virtual void OnCollapse(const Remesh::EdgeCollapse& collapse) = 0;
+	};
+}
+
+#endif /* _Terremesh_ICollapseListener_H__ */
@@ -0,0 +1,201 @@
+#include "FileStream.h"
+
+#ifdef _WIN32
+#include <algorithm>
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace Terremesh
+{
+namespace IO
+{
+	/// Checks whether path ends with extension.
+	static bool HasExtension(const std::string& path, const std::string& extension)
+	{
+		return (path.size() > extension.size()) && (path.compare(path.size() - extension.size(), extension.size(), extension) == 0);
+	}
+
+	/// Switches standard stream to binary mode.
+	static FILE* OpenStandardStream(FILE* file)
+	{
+#ifdef _WIN32
+		_setmode(_fileno(file), _O_BINARY);
+#endif
+		return file;
+	}
+
+	bool FilePath::IsStandardStream(const std::string& path)
+	{
+		return path == "-";
+	}
+
+	Compression FilePath::GetCompression(const std::string& path)
+	{
+		if (HasExtension(path, ".gz"))
+		{
+			return Compression_Gzip;
+		}
+
+		if (HasExtension(path, ".zst"))
+		{
+			return Compression_Zstd;
+		}
+
+		return Compression_None;
+	}
+
+	std::string FilePath::GetContentsPath(const std::string& path)
+	{
+		switch (GetCompression(path))
+		{
+		case Compression_Gzip:
+			return path.substr(0, path.size() - 3);
+		case Compression_Zstd:
+			return path.substr(0, path.size() - 4);
+		default:
+			return path;
+		}
+	}
+
+	std::string FilePath::Quote(const std::string& argument)
+	{
+#ifdef _WIN32
+		// Backslashes before closing quote are doubled, so the program receives them verbatim
+		std::string quoted = argument;
+		size_t backslashes = quoted.size() - std::min(quoted.size(), quoted.find_last_not_of('\\') + 1);
+		quoted.append(backslashes, '\\');
+		quoted = "\"" + quoted + "\"";
+
+		// cmd.exe expands %VAR% even inside quotes, so every metacharacter (including quotes) is escaped by caret
+		std::string result;
+
+		for (auto it = quoted.begin(); it != quoted.end(); ++it)
+		{
+			if (std::string("\"%!^&|<>()").find(*it) != std::string::npos)
+			{
+				result += '^';
+			}
+
+			result += *it;
+		}
+
+		return result;
+#else
+		std::string result = "'";
+
+		for (auto it = argument.begin(); it != argument.end(); ++it)
+		{
+			result += (*it == '\'') ? std::string("'\\''") : std::string(1, *it);
+		}
+
+		return result + "'";
+#endif
+	}
+
+	InputFileStream::InputFileStream(const std::string& path)
+		: std::istream(nullptr)
+	{
+		if (FilePath::IsStandardStream(path))
+		{
+			m_Process.reset(new PipeInputStreamBuffer(OpenStandardStream(stdin)));
+			rdbuf(m_Process.get());
+			return;
+		}
+
+		auto compression = FilePath::GetCompression(path);
+
+		if (compression == Compression_None)
+		{
+			m_Buffer.resize(FileBufferSize);
+			m_File.pubsetbuf(m_Buffer.data(), (std::streamsize)m_Buffer.size());
+			m_File.open(path.c_str(), std::ios::in | std::ios::binary);
+			rdbuf(&m_File);
+			return;
+		}
+
+		// Missing file is reported before decompressor is started
+		std::ifstream probe(path.c_str(), std::ios::in | std::ios::binary);
+
+		if (probe.is_open())
+		{
+			probe.close();
+
+			std::string command = (compression == Compression_Gzip) ? "gzip -dc " : "zstd -dcq ";
+			m_Process.reset(new PipeInputStreamBuffer(command + FilePath::Quote(path)));
+			rdbuf(m_Process.get());
+		}
+		else
+		{
+			rdbuf(&m_File);
+		}
+	}
+
+	bool InputFileStream::IsOpen() const
+	{
+		return (m_Process != nullptr) ? m_Process->IsOpen() : m_File.is_open();
+	}
+
+	bool InputFileStream::Close()
+	{
+		if (m_Process != nullptr)
+		{
+			return m_Process->Close();
+		}
+
+		return m_File.close() != nullptr;
+	}
+
+	OutputFileStream::OutputFileStream(const std::string& path, bool binary)
+		: std::ostream(nullptr)
+	{
+		if (FilePath::IsStandardStream(path))
+		{
+			m_Process.reset(new PipeOutputStreamBuffer(OpenStandardStream(stdout)));
+			rdbuf(m_Process.get());
+			return;
+		}
+
+		auto compression = FilePath::GetCompression(path);
+
+		if (compression == Compression_None)
+		{
+			m_Buffer.resize(FileBufferSize);
+			m_File.pubsetbuf(m_Buffer.data(), (std::streamsize)m_Buffer.size());
+			m_File.open(path.c_str(), binary ? (std::ios::out | std::ios::binary) : std::ios::out);
+			rdbuf(&m_File);
+			return;
+		}
+
+		std::string command = (compression == Compression_Gzip) ? "gzip -c > " : "zstd -qc > ";
+		m_Process.reset(new PipeOutputStreamBuffer(command + FilePath::Quote(path)));
+		m_CompressedPath = path;
+		rdbuf(m_Process.get());
+	}
+
+	bool OutputFileStream::IsOpen() const
+	{
+		return (m_Process != nullptr) ? m_Process->IsOpen() : m_File.is_open();
+	}
+
+	bool OutputFileStream::Close()
+	{
+		bool result = !fail();
+
+		if (m_Process != nullptr)
+		{
+			result = m_Process->Close() && result;
+
+			// Shell creates file before compressor runs
+			if (!result && !m_CompressedPath.empty())
+			{
+				std::remove(m_CompressedPath.c_str());
+			}
+
+			return result;
+		}
+
+		return (m_File.close() != nullptr) && result;
+	}
+}
+}
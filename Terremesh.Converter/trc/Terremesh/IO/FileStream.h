@@ -0,0 +1,151 @@
+#pragma once
+#ifndef _Terremesh_IO_FileStream_H__
+#define _Terremesh_IO_FileStream_H__
+
+#include "../Required.h"
+#include "PipeStreamBuffer.h"
+
+namespace Terremesh
+{
+namespace IO
+{
+	/// Specifies file compression.
+	enum Compression
+	{
+		/// Plain file.
+		Compression_None,
+
+		/// The .gz file, processed by gzip.
+		Compression_Gzip,
+
+		/// The .zst file, processed by zstd.
+		Compression_Zstd,
+	};
+
+	/// The size of buffer of plain file.
+	static const size_t FileBufferSize = 1 << 20;
+
+	/// Implements helpers for compressed file paths.
+	class FilePath
+	{
+	public:
+		/// Checks whether path denotes standard input or output.
+		///
+		/// @param[in] path
+		///		The file path.
+		///
+		/// @retval true when path is "-".
+		/// @retval false otherwise.
+		static bool IsStandardStream(const std::string& path);
+
+		/// Gets compression of file.
+		///
+		/// @param[in] path
+		///		The file path. Extensions ".gz" and ".zst" select compression.
+		///
+		/// @return
+		///		The compression.
+		static Compression GetCompression(const std::string& path);
+
+		/// Removes compression extension from path.
+		///
+		/// @param[in] path
+		///		The file path.
+		///
+		/// @return
+		///		The path of uncompressed contents, e.g. "tile.obj" for "tile.obj.gz".
+		static std::string GetContentsPath(const std::string& path);
+
+		/// Quotes argument of shell command.
+		///
+		/// @remarks
+		///		On Windows the argument is also escaped for cmd.exe, which is used by _popen.
+		static std::string Quote(const std::string& argument);
+	};
+
+	/// Implements binary input file stream, decompressed on the fly.
+	///
+	/// @remarks
+	///		Compressed file is decompressed by gzip or zstd child process,
+	///		whose output is read by dedicated thread while stream consumer
+	///		parses previous blocks. Such stream cannot seek.
+	///
+	///		Path "-" reads standard input the same way, so input can be
+	///		piped from generator of tiles. Only signature of such input can
+	///		be peeked at by seeking within first block.
+	class InputFileStream
+		: public std::istream
+	{
+	public:
+		/// Creates instance of the InputFileStream class.
+		///
+		/// @param[in] path
+		///		The file path.
+		InputFileStream(const std::string& path);
+
+		/// Checks whether file was opened.
+		bool IsOpen() const;
+
+		/// Closes file.
+		///
+		/// @retval true when whole file was read successfully.
+		/// @retval false when decompression failed.
+		bool Close();
+
+	private:
+		InputFileStream(const InputFileStream&);
+		InputFileStream& operator = (const InputFileStream&);
+
+		std::vector<char> m_Buffer;
+		std::filebuf m_File;
+		std::unique_ptr<PipeInputStreamBuffer> m_Process;
+	};
+
+	/// Implements output file stream, compressed on the fly.
+	///
+	/// @remarks
+	///		Compressed file is written by gzip or zstd child process fed
+	///		through pipe, so compression runs alongside stream producer.
+	///
+	///		Path "-" writes standard output in large blocks, so output can be
+	///		piped to compressor or consumer of tiles.
+	class OutputFileStream
+		: public std::ostream
+	{
+	public:
+		/// Creates instance of the OutputFileStream class.
+		///
+		/// @param[in] path
+		///		The file path.
+		/// @param[in] binary
+		///		The value indicating whether plain file is opened in binary mode.
+		OutputFileStream(const std::string& path, bool binary);
+
+		/// Checks whether file was opened.
+		bool IsOpen() const;
+
+		/// Closes file.
+		///
+		/// @retval true when all data was written.
+		/// @retval false otherwise.
+		///
+		/// @remarks
+		///		Compressed file is removed when compression fails, e.g. when
+		///		gzip or zstd is missing, so no empty or truncated file is left.
+		bool Close();
+
+	private:
+		OutputFileStream(const OutputFileStream&);
+		OutputFileStream& operator = (const OutputFileStream&);
+
+		std::vector<char> m_Buffer;
+		std::filebuf m_File;
+		std::unique_ptr<PipeOutputStreamBuffer> m_Process;
+
+		/// The path of compressed file, empty for other outputs.
+		std::string m_CompressedPath;
+	};
+}
+}
+
+#endif /* _Terremesh_IO_FileStream_H__ */
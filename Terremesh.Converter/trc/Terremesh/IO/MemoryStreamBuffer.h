@@ -0,0 +1,59 @@
+#pragma once
+#ifndef _Terremesh_IO_MemoryStreamBuffer_H__
+#define _Terremesh_IO_MemoryStreamBuffer_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace IO
+{
+	/// Implements read-only stream buffer over memory block.
+	///
+	/// @remarks
+	///		Memory is not copied and must outlive buffer.
+	class MemoryStreamBuffer
+		: public std::streambuf
+	{
+	public:
+		/// Creates instance of the MemoryStreamBuffer class.
+		///
+		/// @param[in] data
+		///		The memory block.
+		/// @param[in] size
+		///		The memory block size.
+		MemoryStreamBuffer(const char* data, size_t size)
+		{
+			char* begin = const_cast<char*>(data);
+			setg(begin, begin, begin + size);
+		}
+
+	protected:
+		/// Moves read position relative to beginning, end or current position.
+		virtual pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which)
+		{
+			char* base = (direction == std::ios_base::beg) ? eback() : (direction == std::ios_base::end) ? egptr() : gptr();
+
+			if (((which & std::ios_base::in) == 0) || (offset < eback() - base) || (offset > egptr() - base))
+			{
+				return pos_type(off_type(-1));
+			}
+
+			setg(eback(), base + offset, egptr());
+			return pos_type(gptr() - eback());
+		}
+
+		/// Moves read position to absolute position.
+		virtual pos_type seekpos(pos_type position, std::ios_base::openmode which)
+		{
+			return seekoff(off_type(position), std::ios_base::beg, which);
+		}
+
+	private:
+		MemoryStreamBuffer(const MemoryStreamBuffer&);
+		MemoryStreamBuffer& operator = (const MemoryStreamBuffer&);
+	};
+}
+}
+
+#endif /* _Terremesh_IO_MemoryStreamBuffer_H__ */
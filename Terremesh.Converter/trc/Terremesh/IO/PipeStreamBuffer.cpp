@@ -0,0 +1,270 @@
+#include "PipeStreamBuffer.h"
+
+#ifdef _MSC_VER
+#define popen _popen
+#define pclose _pclose
+#endif
+
+#ifndef _WIN32
+#include <csignal>
+#endif
+
+namespace Terremesh
+{
+namespace IO
+{
+#ifdef _WIN32
+	static const char* const ReadMode = "rb";
+	static const char* const WriteMode = "wb";
+#else
+	static const char* const ReadMode = "r";
+	static const char* const WriteMode = "w";
+#endif
+
+	PipeInputStreamBuffer::PipeInputStreamBuffer(const std::string& command)
+		: m_Pipe(popen(command.c_str(), ReadMode))
+		, m_Owned(true)
+		, m_Offset(0)
+		, m_Finished(false)
+		, m_Stopped(false)
+		, m_Failed(false)
+	{
+		Start();
+	}
+
+	PipeInputStreamBuffer::PipeInputStreamBuffer(FILE* file)
+		: m_Pipe(file)
+		, m_Owned(false)
+		, m_Offset(0)
+		, m_Finished(false)
+		, m_Stopped(false)
+		, m_Failed(false)
+	{
+		Start();
+	}
+
+	PipeInputStreamBuffer::~PipeInputStreamBuffer()
+	{
+		Close();
+	}
+
+	void PipeInputStreamBuffer::Start()
+	{
+		if (m_Pipe != nullptr)
+		{
+			m_Reader = std::thread([this]() { ReadBlocks(); });
+		}
+	}
+
+	void PipeInputStreamBuffer::ReadBlocks()
+	{
+		for (;;)
+		{
+			std::vector<char> block(BlockSize);
+			size_t count = fread(block.data(), 1, block.size(), m_Pipe);
+
+			if (count == 0)
+			{
+				break;
+			}
+
+			block.resize(count);
+
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [this]() { return m_Stopped || (m_Blocks.size() < MaxBlocks); });
+
+			if (m_Stopped)
+			{
+				break;
+			}
+
+			m_Blocks.push_back(std::vector<char>());
+			m_Blocks.back().swap(block);
+			m_Condition.notify_all();
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Failed = ferror(m_Pipe) != 0;
+		m_Finished = true;
+		m_Condition.notify_all();
+	}
+
+	PipeInputStreamBuffer::int_type PipeInputStreamBuffer::underflow()
+	{
+		if (gptr() < egptr())
+		{
+			return traits_type::to_int_type(*gptr());
+		}
+
+		if (m_Pipe == nullptr)
+		{
+			return traits_type::eof();
+		}
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return m_Finished || !m_Blocks.empty(); });
+
+		if (m_Blocks.empty())
+		{
+			return traits_type::eof();
+		}
+
+		m_Offset += m_Current.size();
+		m_Current.swap(m_Blocks.front());
+		m_Blocks.pop_front();
+		m_Condition.notify_all();
+
+		setg(m_Current.data(), m_Current.data(), m_Current.data() + m_Current.size());
+		return traits_type::to_int_type(*gptr());
+	}
+
+	PipeInputStreamBuffer::pos_type PipeInputStreamBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode)
+	{
+		if ((mode & std::ios_base::in) == 0)
+		{
+			return pos_type(off_type(-1));
+		}
+
+		// Block is loaded first, so peeking from start of stream can rewind
+		if ((eback() == nullptr) && (m_Offset == 0))
+		{
+			underflow();
+		}
+
+		off_type position;
+
+		switch (direction)
+		{
+		case std::ios_base::beg:
+			position = offset;
+			break;
+		case std::ios_base::cur:
+			position = (off_type)(m_Offset + (gptr() - eback())) + offset;
+			break;
+		default:
+			return pos_type(off_type(-1));
+		}
+
+		if ((position < (off_type)m_Offset) || (position > (off_type)(m_Offset + m_Current.size())))
+		{
+			return pos_type(off_type(-1));
+		}
+
+		setg(eback(), eback() + (size_t)(position - (off_type)m_Offset), egptr());
+		return pos_type(position);
+	}
+
+	PipeInputStreamBuffer::pos_type PipeInputStreamBuffer::seekpos(pos_type position, std::ios_base::openmode mode)
+	{
+		return seekoff(off_type(position), std::ios_base::beg, mode);
+	}
+
+	bool PipeInputStreamBuffer::Close()
+	{
+		if (m_Pipe == nullptr)
+		{
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopped = true;
+			m_Condition.notify_all();
+		}
+
+		m_Reader.join();
+
+		bool result = !m_Failed && m_Blocks.empty() && (gptr() == egptr());
+
+		if (m_Owned)
+		{
+			result = (pclose(m_Pipe) == 0) && result;
+		}
+
+		m_Pipe = nullptr;
+
+		return result;
+	}
+
+	PipeOutputStreamBuffer::PipeOutputStreamBuffer(const std::string& command)
+		: m_Pipe(popen(command.c_str(), WriteMode))
+		, m_Owned(true)
+		, m_Buffer(BlockSize)
+		, m_Failed(false)
+	{
+#ifndef _WIN32
+		// Process which exited early fails write instead of terminating converter
+		signal(SIGPIPE, SIG_IGN);
+#endif
+
+		setp(m_Buffer.data(), m_Buffer.data() + m_Buffer.size());
+	}
+
+	PipeOutputStreamBuffer::PipeOutputStreamBuffer(FILE* file)
+		: m_Pipe(file)
+		, m_Owned(false)
+		, m_Buffer(BlockSize)
+		, m_Failed(false)
+	{
+		setp(m_Buffer.data(), m_Buffer.data() + m_Buffer.size());
+	}
+
+	PipeOutputStreamBuffer::~PipeOutputStreamBuffer()
+	{
+		Close();
+	}
+
+	bool PipeOutputStreamBuffer::Flush()
+	{
+		size_t count = (size_t)(pptr() - pbase());
+
+		if ((count > 0) && (fwrite(pbase(), 1, count, m_Pipe) != count))
+		{
+			m_Failed = true;
+		}
+
+		setp(m_Buffer.data(), m_Buffer.data() + m_Buffer.size());
+		return !m_Failed;
+	}
+
+	PipeOutputStreamBuffer::int_type PipeOutputStreamBuffer::overflow(int_type value)
+	{
+		if ((m_Pipe == nullptr) || !Flush())
+		{
+			return traits_type::eof();
+		}
+
+		if (!traits_type::eq_int_type(value, traits_type::eof()))
+		{
+			*pptr() = traits_type::to_char_type(value);
+			pbump(1);
+		}
+
+		return traits_type::not_eof(value);
+	}
+
+	int PipeOutputStreamBuffer::sync()
+	{
+		if ((m_Pipe == nullptr) || !Flush() || (fflush(m_Pipe) != 0))
+		{
+			return -1;
+		}
+
+		return 0;
+	}
+
+	bool PipeOutputStreamBuffer::Close()
+	{
+		if (m_Pipe == nullptr)
+		{
+			return false;
+		}
+
+		bool result = Flush();
+		result = (m_Owned ? (pclose(m_Pipe) == 0) : (fflush(m_Pipe) == 0)) && result;
+		m_Pipe = nullptr;
+
+		return result;
+	}
+}
+}
@@ -0,0 +1,152 @@
+#pragma once
+#ifndef _Terremesh_IO_PipeStreamBuffer_H__
+#define _Terremesh_IO_PipeStreamBuffer_H__
+
+#include "../Required.h"
+#include <cstdio>
+
+namespace Terremesh
+{
+namespace IO
+{
+	/// Implements stream buffer reading standard output of child process or standard input.
+	///
+	/// @remarks
+	///		Dedicated thread reads pipe into queue of blocks, so the producer
+	///		and reading thread run ahead of consumer by a few blocks. Seeking
+	///		is limited to block being consumed, which is enough to peek at
+	///		file signature.
+	class PipeInputStreamBuffer
+		: public std::streambuf
+	{
+	public:
+		/// Creates instance of the PipeInputStreamBuffer class.
+		///
+		/// @param[in] command
+		///		The shell command writing data to its standard output.
+		PipeInputStreamBuffer(const std::string& command);
+
+		/// Creates instance of the PipeInputStreamBuffer class.
+		///
+		/// @param[in] file
+		///		The open file, e.g. stdin. It is not closed by stream buffer.
+		PipeInputStreamBuffer(FILE* file);
+
+		/// Destroys instance of the PipeInputStreamBuffer class.
+		virtual ~PipeInputStreamBuffer();
+
+		/// Checks whether process was started.
+		bool IsOpen() const { return m_Pipe != nullptr; }
+
+		/// Stops reading and waits for process.
+		///
+		/// @retval true when process succeeded and all its output was read.
+		/// @retval false otherwise.
+		bool Close();
+
+	protected:
+		virtual int_type underflow();
+		virtual pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode);
+		virtual pos_type seekpos(pos_type position, std::ios_base::openmode mode);
+
+	private:
+		PipeInputStreamBuffer(const PipeInputStreamBuffer&);
+		PipeInputStreamBuffer& operator = (const PipeInputStreamBuffer&);
+
+		/// Starts reading thread.
+		void Start();
+
+		/// Reads pipe into queue until end of output.
+		void ReadBlocks();
+
+		/// The size of block read from pipe.
+		static const size_t BlockSize = 1 << 20;
+
+		/// The maximum number of blocks waiting for consumer.
+		static const size_t MaxBlocks = 4;
+
+		FILE* m_Pipe;
+
+		/// The value indicating whether pipe is closed by stream buffer.
+		bool m_Owned;
+
+		std::thread m_Reader;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+
+		/// Blocks read ahead.
+		std::deque<std::vector<char> > m_Blocks;
+
+		/// Block being consumed.
+		std::vector<char> m_Current;
+
+		/// The stream position of block being consumed.
+		size_t m_Offset;
+
+		/// The value indicating whether reader reached end of output.
+		bool m_Finished;
+
+		/// The value indicating whether consumer stopped reading.
+		bool m_Stopped;
+
+		/// The value indicating whether pipe read failed.
+		bool m_Failed;
+	};
+
+	/// Implements stream buffer writing to standard input of child process or standard output.
+	class PipeOutputStreamBuffer
+		: public std::streambuf
+	{
+	public:
+		/// Creates instance of the PipeOutputStreamBuffer class.
+		///
+		/// @param[in] command
+		///		The shell command reading data from its standard input.
+		PipeOutputStreamBuffer(const std::string& command);
+
+		/// Creates instance of the PipeOutputStreamBuffer class.
+		///
+		/// @param[in] file
+		///		The open file, e.g. stdout. It is flushed, but not closed by stream buffer.
+		PipeOutputStreamBuffer(FILE* file);
+
+		/// Destroys instance of the PipeOutputStreamBuffer class.
+		virtual ~PipeOutputStreamBuffer();
+
+		/// Checks whether process was started.
+		bool IsOpen() const { return m_Pipe != nullptr; }
+
+		/// Flushes data, closes process input and waits for process.
+		///
+		/// @retval true when all data was written and process succeeded.
+		/// @retval false otherwise.
+		bool Close();
+
+	protected:
+		virtual int_type overflow(int_type value);
+		virtual int sync();
+
+	private:
+		PipeOutputStreamBuffer(const PipeOutputStreamBuffer&);
+		PipeOutputStreamBuffer& operator = (const PipeOutputStreamBuffer&);
+
+		/// Writes buffered data into pipe.
+		bool Flush();
+
+		/// The size of buffer.
+		static const size_t BlockSize = 1 << 20;
+
+		FILE* m_Pipe;
+
+		/// The value indicating whether pipe is closed by stream buffer.
+		bool m_Owned;
+
+		std::vector<char> m_Buffer;
+
+		/// The value indicating whether pipe write failed.
+		bool m_Failed;
+	};
+}
+}
+
+#endif /* _Terremesh_IO_PipeStreamBuffer_H__ */
@@ -0,0 +1,126 @@
+#include "PositionalFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Terremesh
+{
+namespace IO
+{
+#ifdef _WIN32
+	PositionalFile::PositionalFile(const std::string& path)
+		: m_Handle(CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr))
+	{
+	}
+
+	bool PositionalFile::IsOpen() const
+	{
+		return m_Handle != INVALID_HANDLE_VALUE;
+	}
+
+	bool PositionalFile::Resize(unsigned long long size)
+	{
+		LARGE_INTEGER position;
+		position.QuadPart = (LONGLONG)size;
+
+		return IsOpen() && SetFilePointerEx(m_Handle, position, nullptr, FILE_BEGIN) && SetEndOfFile(m_Handle);
+	}
+
+	bool PositionalFile::Write(unsigned long long offset, const char* data, size_t size)
+	{
+		while (size > 0)
+		{
+			// Offset of overlapped structure makes write positional
+			OVERLAPPED overlapped = {};
+			overlapped.Offset = (DWORD)offset;
+			overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+			DWORD chunk = (DWORD)std::min(size, (size_t)(1 << 30));
+			DWORD written = 0;
+
+			if (!WriteFile(m_Handle, data, chunk, &written, &overlapped) || (written == 0))
+			{
+				return false;
+			}
+
+			offset += written;
+			data += written;
+			size -= written;
+		}
+
+		return true;
+	}
+
+	bool PositionalFile::Close()
+	{
+		if (!IsOpen())
+		{
+			return false;
+		}
+
+		bool result = CloseHandle(m_Handle) != FALSE;
+		m_Handle = INVALID_HANDLE_VALUE;
+
+		return result;
+	}
+#else
+	PositionalFile::PositionalFile(const std::string& path)
+		: m_Handle(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666))
+	{
+	}
+
+	bool PositionalFile::IsOpen() const
+	{
+		return m_Handle >= 0;
+	}
+
+	bool PositionalFile::Resize(unsigned long long size)
+	{
+		return IsOpen() && (ftruncate(m_Handle, (off_t)size) == 0);
+	}
+
+	bool PositionalFile::Write(unsigned long long offset, const char* data, size_t size)
+	{
+		while (size > 0)
+		{
+			ssize_t written = pwrite(m_Handle, data, size, (off_t)offset);
+
+			if (written <= 0)
+			{
+				return false;
+			}
+
+			offset += (unsigned long long)written;
+			data += written;
+			size -= (size_t)written;
+		}
+
+		return true;
+	}
+
+	bool PositionalFile::Close()
+	{
+		if (!IsOpen())
+		{
+			return false;
+		}
+
+		bool result = close(m_Handle) == 0;
+		m_Handle = -1;
+
+		return result;
+	}
+#endif
+
+	PositionalFile::~PositionalFile()
+	{
+		Close();
+	}
+}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#ifndef _Terremesh_IO_PositionalFile_H__
+#define _Terremesh_IO_PositionalFile_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace IO
+{
+	/// Implements output file written at explicit offsets.
+	///
+	/// @remarks
+	///		File is sized up front, then ranges are written independently,
+	///		so multiple threads can write disjoint ranges concurrently.
+	class PositionalFile
+	{
+	public:
+		/// Creates file, truncating existing one.
+		///
+		/// @param[in] path
+		///		The file path.
+		PositionalFile(const std::string& path);
+
+		/// Destroys instance of the PositionalFile class.
+		~PositionalFile();
+
+		/// Checks whether file was created.
+		bool IsOpen() const;
+
+		/// Sets size of file.
+		///
+		/// @param[in] size
+		///		The size in bytes.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Resize(unsigned long long size);
+
+		/// Writes data at offset.
+		///
+		/// @param[in] offset
+		///		The offset from file start.
+		/// @param[in] data
+		///		The data.
+		/// @param[in] size
+		///		The size of data.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Write(unsigned long long offset, const char* data, size_t size);
+
+		/// Closes file.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Close();
+
+	private:
+		PositionalFile(const PositionalFile&);
+		PositionalFile& operator = (const PositionalFile&);
+
+#ifdef _WIN32
+		void* m_Handle;
+#else
+		int m_Handle;
+#endif
+	};
+}
+}
+
+#endif /* _Terremesh_IO_PositionalFile_H__ */
@@ -3,6 +3,9 @@
 #define _Terremesh_IRemeshingMethod_H__
 
 #include "Remesh/Mesh.h"
+#include "IProgressListener.h"
+#include "ISnapshotListener.h"
+#include "Threading/TaskScheduler.h"
 
 namespace Terremesh
 {
@@ -30,6 +33,20 @@ namespace Terremesh
 		/// @param[in] listener
 		///		The progress listener.
 		virtual void Process(Remesh::Mesh& mesh, int targetTriangles, IProgressListener* listener) = 0;
+
+		/// Processes mesh using multiple triangles counts in single pass.
+		///
+		/// @param[in,out] mesh
+		///		The mesh to process. Receives mesh for largest target.
+		/// @param[in] targetTriangles
+		///		The numbers of target triangles.
+		/// @param[in] snapshots
+		///		The listener receiving mesh for each target.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler running parallel parts of method, or nullptr.
+		virtual void Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler) = 0;
 	};
 }
 
@@ -0,0 +1,25 @@
+#pragma once
+#ifndef _Terremesh_ISnapshotListener_H__
+#define _Terremesh_ISnapshotListener_H__
+
+#include "Required.h"
+#include "Remesh/Mesh.h"
+
+namespace Terremesh
+{
+	/// Provides interface for receiving intermediate meshes of remeshing.
+	struct ISnapshotListener
+	{
+		virtual ~ISnapshotListener() {}
+
+		/// Receives mesh snapshot.
+		///
+		/// @param[in] index
+		///		The index of reached target in targets list.
+		/// @param[in] mesh
+		///		The mesh snapshot.
+		virtual void OnSnapshot(size_t index, const Remesh::Mesh& mesh) = 0;
+	};
+}
+
+#endif /* _Terremesh_ISnapshotListener_H__ */
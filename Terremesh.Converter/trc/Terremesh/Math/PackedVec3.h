@@ -0,0 +1,59 @@
+#pragma once
+#ifndef _Terremesh_Math_PackedVec3_H__
+#define _Terremesh_Math_PackedVec3_H__
+
+#include "../Required.h"
+#include "Vec3.h"
+
+namespace Terremesh
+{
+namespace Math
+{
+	/// Implements storage of vector with chosen precision.
+	///
+	/// @remarks
+	///		Vector converts to and from Vec3, so all arithmetic on it is done
+	///		in double precision.
+	template <typename TScalar>
+	struct PackedVec3
+	{
+	public:
+		/// Creates instance of the PackedVec3 structure.
+		PackedVec3()
+			: X(0)
+			, Y(0)
+			, Z(0)
+		{
+		}
+
+		/// Creates instance of the PackedVec3 structure.
+		///
+		/// @param[in] value
+		///		The source vector.
+		PackedVec3(const Vec3& value)
+			: X((TScalar)value.X)
+			, Y((TScalar)value.Y)
+			, Z((TScalar)value.Z)
+		{
+		}
+
+		/// Converts vector to double precision.
+		operator Vec3() const
+		{
+			return Vec3(X, Y, Z);
+		}
+
+	public:
+		/// The X component.
+		TScalar X;
+
+		/// The Y component.
+		TScalar Y;
+
+		/// The Z component.
+		TScalar Z;
+	};
+}
+}
+
+#endif /* _Terremesh_Math_PackedVec3_H__ */
@@ -130,6 +130,20 @@ namespace Math
 			result.Z = value1.Z - value2.Z;
 		}
 
+		/// Computes dot product of two vectors.
+		///
+		/// @param[in] value1
+		///		The source vector.
+		/// @param[in] value2
+		///		The source vector.
+		///
+		/// @returns
+		///		The dot product.
+		static double Dot(const Vec3& value1, const Vec3& value2)
+		{
+			return value1.X * value2.X + value1.Y * value2.Y + value1.Z * value2.Z;
+		}
+
 	public:
 		/// The X component.
 		double X;
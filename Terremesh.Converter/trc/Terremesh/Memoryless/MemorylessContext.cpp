@@ -0,0 +1,141 @@
+#include "MemorylessContext.h"
+
+namespace Terremesh
+{
+namespace Memoryless
+{
+	const Remesh::VertexId MemorylessContext::NoVertex;
+
+	void MemorylessContext::Load(const Remesh::Mesh& mesh)
+	{
+		Clear();
+
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		// Vertex IDs are sorted, so vertex indices preserve their order
+		std::vector<Remesh::VertexId> indices;
+
+		if (!vertices.empty())
+		{
+			indices.resize((size_t)vertices.rbegin()->first + 1, NoVertex);
+		}
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			indices[it->first] = (Remesh::VertexId)Positions.size();
+			Positions.push_back(it->second.Position);
+			VertexIds.push_back(it->first);
+		}
+
+		VertexAlive.resize(Positions.size(), 1);
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it)
+		{
+			Remesh::Triangle triangle = *it;
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				triangle.Vertices[j] = indices[triangle.Vertices[j]];
+			}
+
+			Triangles.push_back(triangle);
+		}
+
+		TriangleAlive.resize(Triangles.size(), 1);
+		TriangleCount = Triangles.size();
+
+		// Build vertex to triangle adjacency, keeping triangle order for each vertex
+		VertexTriangleOffsets.assign(Positions.size() + 1, 0);
+
+		for (auto it = Triangles.begin(); it != Triangles.end(); ++it)
+		{
+			for (auto vertex = 0; vertex < 3; ++vertex)
+			{
+				++VertexTriangleOffsets[it->Vertices[vertex] + 1];
+			}
+		}
+
+		for (size_t i = 1; i < VertexTriangleOffsets.size(); ++i)
+		{
+			VertexTriangleOffsets[i] += VertexTriangleOffsets[i - 1];
+		}
+
+		VertexTriangles.resize(VertexTriangleOffsets.back());
+
+		std::vector<size_t> next(VertexTriangleOffsets.begin(), VertexTriangleOffsets.end() - 1);
+
+		for (size_t i = 0; i < Triangles.size(); ++i)
+		{
+			for (auto vertex = 0; vertex < 3; ++vertex)
+			{
+				VertexTriangles[next[Triangles[i].Vertices[vertex]]++] = i;
+			}
+		}
+
+		// Each vertex starts as chain of its own triangles
+		NextMerged.assign(Positions.size(), NoVertex);
+		LastMerged.resize(Positions.size());
+
+		for (size_t i = 0; i < Positions.size(); ++i)
+		{
+			LastMerged[i] = (Remesh::VertexId)i;
+		}
+	}
+
+	void MemorylessContext::Store(Remesh::Mesh& mesh) const
+	{
+		Remesh::Mesh::VertexContainer vertices;
+		Remesh::Mesh::TriangleContainer triangles;
+
+		for (size_t i = 0; i < Positions.size(); ++i)
+		{
+			if (VertexAlive[i])
+			{
+				vertices.insert(vertices.end(), std::make_pair(VertexIds[i], Remesh::Vertex(Positions[i])));
+			}
+		}
+
+		for (size_t i = 0; i < Triangles.size(); ++i)
+		{
+			if (TriangleAlive[i])
+			{
+				Remesh::Triangle triangle = Triangles[i];
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					triangle.Vertices[j] = VertexIds[triangle.Vertices[j]];
+				}
+
+				triangles.push_back(triangle);
+			}
+		}
+
+		mesh.SetVertices(vertices);
+		mesh.SetTriangles(triangles);
+	}
+
+	void MemorylessContext::Clear()
+	{
+		Positions.clear();
+		VertexIds.clear();
+		VertexAlive.clear();
+		Triangles.clear();
+		TriangleAlive.clear();
+		TriangleCount = 0;
+		VertexTriangleOffsets.clear();
+		VertexTriangles.clear();
+		NextMerged.clear();
+		LastMerged.clear();
+		Edges.Clear();
+		Queue.clear();
+		EdgeKeys.clear();
+		Ring.clear();
+		Evaluated.clear();
+		Neighbors.clear();
+		Collapse.RemovedTriangles.clear();
+		Collapse.ChangedTriangles.clear();
+		Scheduler = nullptr;
+	}
+}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#ifndef _Terremesh_Memoryless_MemorylessContext_H__
+#define _Terremesh_Memoryless_MemorylessContext_H__
+
+#include "../Required.h"
+
+#include "../ICollapseListener.h"
+#include "../Remesh/Mesh.h"
+#include "../Remesh/EdgeCollapse.h"
+#include "../Threading/TaskScheduler.h"
+#include "../QuadricErrorMetric/EdgeErrorTable.h"
+
+namespace Terremesh
+{
+namespace Memoryless
+{
+	/// Describes candidate collapse waiting in queue.
+	struct QueuedEdge
+	{
+	public:
+		/// The edge error when queued.
+		double Error;
+
+		/// The edge key.
+		QuadricErrorMetric::EdgeErrorTable::Key Key;
+
+		/// Orders edges so cheapest edge with lowest pair is on top of heap.
+		bool operator < (const QueuedEdge& other) const
+		{
+			return (Error > other.Error) || ((Error == other.Error) && (Key > other.Key));
+		}
+	};
+
+	/// Implements per-job state of memoryless method.
+	///
+	/// @remarks
+	///		Vertices are addressed by dense indices, triangles by input mesh
+	///		indices. Triangles adjacent to vertex are kept in static lists of
+	///		input triangles; collapse appends list of removed vertex to list of
+	///		kept one, so current triangles of vertex are found by walking its
+	///		chain of lists and skipping removed triangles. No per-vertex
+	///		quadrics are stored.
+	class MemorylessContext
+	{
+	public:
+		/// Marks end of merged chain and missing vertex.
+		static const Remesh::VertexId NoVertex = ~0U;
+
+		/// Creates instance of the MemorylessContext class.
+		MemorylessContext()
+			: TriangleCount(0)
+			, Scheduler(nullptr)
+			, m_CollapseListener(nullptr)
+		{
+		}
+
+		/// Loads mesh into context.
+		///
+		/// @param[in] mesh
+		///		The mesh.
+		void Load(const Remesh::Mesh& mesh);
+
+		/// Stores remaining vertices and triangles into mesh.
+		///
+		/// @param[out] mesh
+		///		The mesh.
+		void Store(Remesh::Mesh& mesh) const;
+
+		/// Removes all state, keeping allocated capacity.
+		void Clear();
+
+		/// Gets listener receiving performed collapses.
+		///
+		/// @return
+		///		The collapse listener.
+		ICollapseListener* GetCollapseListener() const { return m_CollapseListener; }
+
+		/// Sets listener receiving performed collapses.
+		///
+		/// @param[in] value
+		///		The collapse listener or nullptr.
+		void SetCollapseListener(ICollapseListener* value) { m_CollapseListener = value; }
+
+	public:
+		/// Vertex positions, by vertex index.
+		std::vector<Math::Vec3> Positions;
+
+		/// Mesh vertex IDs, by vertex index.
+		std::vector<Remesh::VertexId> VertexIds;
+
+		/// Vertex presence flags.
+		std::vector<char> VertexAlive;
+
+		/// Triangles referencing vertex indices, by triangle index.
+		std::vector<Remesh::Triangle> Triangles;
+
+		/// Triangle presence flags.
+		std::vector<char> TriangleAlive;
+
+		/// The number of present triangles.
+		size_t TriangleCount;
+
+		/// Offsets of vertex entries in VertexTriangles, by vertex index.
+		std::vector<size_t> VertexTriangleOffsets;
+
+		/// Input triangles adjacent to vertex, in triangle order.
+		std::vector<size_t> VertexTriangles;
+
+		/// Next vertex merged into chain, or NoVertex, by vertex index.
+		std::vector<Remesh::VertexId> NextMerged;
+
+		/// Last vertex merged into chain, by vertex index.
+		std::vector<Remesh::VertexId> LastMerged;
+
+		/// Current edge errors.
+		QuadricErrorMetric::EdgeErrorTable Edges;
+
+		/// Queued edges, ordered as heap. May hold outdated entries.
+		std::vector<QueuedEdge> Queue;
+
+		/// Edge keys being inserted or updated.
+		std::vector<QuadricErrorMetric::EdgeErrorTable::Key> EdgeKeys;
+
+		/// Triangles being gathered.
+		std::vector<size_t> Ring;
+
+		/// Triangles of edge being evaluated.
+		std::vector<size_t> Evaluated;
+
+		/// Vertices being gathered.
+		std::vector<Remesh::VertexId> Neighbors;
+
+		/// Collapse being performed.
+		Remesh::EdgeCollapse Collapse;
+
+		/// The scheduler running parallel parts of job, or nullptr.
+		Threading::TaskScheduler* Scheduler;
+
+	private:
+		MemorylessContext(const MemorylessContext&);
+		MemorylessContext& operator = (const MemorylessContext&);
+
+		/// Collapse listener.
+		ICollapseListener* m_CollapseListener;
+	};
+}
+}
+
+#endif /* _Terremesh_Memoryless_MemorylessContext_H__ */
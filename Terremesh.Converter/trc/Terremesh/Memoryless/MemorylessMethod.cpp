@@ -0,0 +1,599 @@
+#include "MemorylessMethod.h"
+
+#include "../Math/Plane.h"
+#include "../Math/Vec3.h"
+
+namespace Terremesh
+{
+namespace Memoryless
+{
+	using QuadricErrorMetric::EdgeErrorTable;
+	using QuadricErrorMetric::ErrorMetric;
+
+	/// The weight of planes keeping boundary edges in place.
+	static const double BoundaryWeight = 100.0;
+
+	/// Queues edge unless its error is too large to ever be collapsed.
+	static void QueueEdge(MemorylessContext& context, EdgeErrorTable::Key key, double error)
+	{
+		if (error < (double)std::numeric_limits<int>::max())
+		{
+			QueuedEdge edge = { error, key };
+
+			context.Queue.push_back(edge);
+			std::push_heap(context.Queue.begin(), context.Queue.end());
+		}
+	}
+
+	/// Reports progress, halving both counts until they fit listener.
+	static void ReportStep(IProgressListener* listener, size_t current, size_t total)
+	{
+		while (total > (size_t)std::numeric_limits<int>::max())
+		{
+			current >>= 1;
+			total >>= 1;
+		}
+
+		listener->OnStep((int)current, (int)total);
+	}
+
+	void MemorylessMethod::Process(Remesh::Mesh& mesh, double targetRatio, IProgressListener* listener)
+	{
+		size_t totalTriangles = mesh.GetTriangles().size();
+		std::vector<size_t> targets(1, (size_t)(targetRatio * totalTriangles));
+
+		Process(mesh, targets, nullptr, listener, nullptr);
+	}
+
+	void MemorylessMethod::Process(Remesh::Mesh& mesh, int targetTriangles, IProgressListener* listener)
+	{
+		std::vector<size_t> targets(1, (size_t)std::max(targetTriangles, 0));
+
+		Process(mesh, targets, nullptr, listener, nullptr);
+	}
+
+	void MemorylessMethod::Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler)
+	{
+		MemorylessContext context;
+
+		Process(mesh, targetTriangles, context, snapshots, listener, scheduler);
+	}
+
+	void MemorylessMethod::Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, MemorylessContext& context, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler) const
+	{
+		context.Load(mesh);
+		context.Scheduler = scheduler;
+
+		Initialize(context, listener);
+		Remesh(context, targetTriangles, snapshots, listener);
+
+		context.Store(mesh);
+
+		// Release working state, keeping capacity for next mesh.
+		context.Clear();
+	}
+
+	void MemorylessMethod::Initialize(MemorylessContext& context, IProgressListener* listener) const
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Selecting pairs");
+		}
+
+		auto& edges = context.Edges;
+		auto& keys = context.EdgeKeys;
+
+		keys.clear();
+
+		for (auto it = context.Triangles.begin(); it != context.Triangles.end(); ++it)
+		{
+			// Collect edges 01, 12 and 20, costs are computed below
+			for (auto vertex = 0; vertex < 3; ++vertex)
+			{
+				auto next = (vertex + 1) % 3;
+
+				keys.push_back(EdgeErrorTable::MakeKey(
+					std::min(it->Vertices[vertex], it->Vertices[next]),
+					std::max(it->Vertices[vertex], it->Vertices[next])));
+			}
+		}
+
+		edges.InsertBatch(keys.data(), keys.size(), 0.0);
+
+		// Compute edge costs
+		Threading::ParallelFor(context.Scheduler, 0, edges.GetCapacity(), 4096,
+			[&](size_t begin, size_t end)
+			{
+				std::vector<size_t> ring;
+
+				for (size_t i = begin; i < end; ++i)
+				{
+					if (edges.IsOccupied(i))
+					{
+						edges.SetError(i, ComputeError(context, edges.GetKey(i), ring));
+					}
+				}
+			});
+
+		RebuildQueue(context);
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Selecting pairs");
+		}
+	}
+
+	void MemorylessMethod::EmitSnapshot(const MemorylessContext& context, size_t index, ISnapshotListener* snapshots) const
+	{
+		if (snapshots != nullptr)
+		{
+			Remesh::Mesh snapshot;
+			context.Store(snapshot);
+
+			snapshots->OnSnapshot(index, snapshot);
+		}
+	}
+
+	EdgeErrorTable::Key MemorylessMethod::PopCheapestEdge(MemorylessContext& context) const
+	{
+		auto& edges = context.Edges;
+		auto& queue = context.Queue;
+
+		while (!queue.empty())
+		{
+			std::pop_heap(queue.begin(), queue.end());
+			QueuedEdge edge = queue.back();
+			queue.pop_back();
+
+			// Entry is outdated when edge was removed or evaluated again
+			size_t slot = edges.Find(edge.Key);
+
+			if ((slot == EdgeErrorTable::InvalidSlot) || (edges.GetError(slot) != edge.Error))
+			{
+				continue;
+			}
+
+			// Edges left without triangles may reference removed vertices
+			if (!context.VertexAlive[EdgeErrorTable::GetFirst(edge.Key)] ||
+				!context.VertexAlive[EdgeErrorTable::GetSecond(edge.Key)])
+			{
+				edges.Erase(edge.Key);
+				continue;
+			}
+
+			return edge.Key;
+		}
+
+		return NoEdge;
+	}
+
+	void MemorylessMethod::RebuildQueue(MemorylessContext& context) const
+	{
+		auto& edges = context.Edges;
+		auto& queue = context.Queue;
+
+		queue.clear();
+
+		for (size_t i = 0; i < edges.GetCapacity(); ++i)
+		{
+			if (edges.IsOccupied(i) && (edges.GetError(i) < (double)std::numeric_limits<int>::max()))
+			{
+				QueuedEdge edge = { edges.GetError(i), edges.GetKey(i) };
+				queue.push_back(edge);
+			}
+		}
+
+		std::make_heap(queue.begin(), queue.end());
+	}
+
+	void MemorylessMethod::GatherTriangles(const MemorylessContext& context, Remesh::VertexId vertex, std::vector<size_t>& triangles) const
+	{
+		// Walk lists of all vertices merged into this one
+		for (auto merged = vertex; merged != MemorylessContext::NoVertex; merged = context.NextMerged[merged])
+		{
+			for (auto i = context.VertexTriangleOffsets[merged]; i < context.VertexTriangleOffsets[merged + 1]; ++i)
+			{
+				auto triangle = context.VertexTriangles[i];
+
+				if (context.TriangleAlive[triangle])
+				{
+					triangles.push_back(triangle);
+				}
+			}
+		}
+	}
+
+	void MemorylessMethod::AddTriangles(const MemorylessContext& context, Remesh::VertexId vertex, Remesh::VertexId skipped, ErrorMetric& metric, std::vector<size_t>& ring) const
+	{
+		ring.clear();
+		GatherTriangles(context, vertex, ring);
+
+		for (auto it = ring.begin(); it != ring.end(); ++it)
+		{
+			auto& triangle = context.Triangles[*it];
+			auto& pos1 = context.Positions[triangle.Vertices[0]];
+			auto& pos2 = context.Positions[triangle.Vertices[1]];
+			auto& pos3 = context.Positions[triangle.Vertices[2]];
+
+			Math::Plane plane;
+			plane.Normal.X = (pos2.Y - pos1.Y) * (pos3.Z - pos1.Z) - (pos2.Z - pos1.Z) * (pos3.Y - pos1.Y);
+			plane.Normal.Y = (pos2.Z - pos1.Z) * (pos3.X - pos1.X) - (pos2.X - pos1.X) * (pos3.Z - pos1.Z);
+			plane.Normal.Z = (pos2.X - pos1.X) * (pos3.Y - pos1.Y) - (pos2.Y - pos1.Y) * (pos3.X - pos1.X);
+
+			// Degenerate triangles have no plane
+			double length = plane.Normal.Length();
+
+			if (!(length > 0.0))
+			{
+				continue;
+			}
+
+			plane.Normal.Normalize();
+			plane.D = - (plane.Normal.X * pos1.X + plane.Normal.Y * pos1.Y + plane.Normal.Z * pos1.Z);
+
+			// Planes of triangles shared with skipped vertex are already added
+			if ((skipped == MemorylessContext::NoVertex) || !triangle.HasVertex(skipped))
+			{
+				ErrorMetric::Add(metric, metric, m_EnableAreaWeights
+					? ErrorMetric(plane, 0.5 * length)
+					: ErrorMetric(plane));
+			}
+
+			// Edges of vertex used by single triangle lie on boundary
+			for (auto j = 0; j < 3; ++j)
+			{
+				auto other = triangle.Vertices[j];
+
+				if ((other == vertex) || (other == skipped))
+				{
+					continue;
+				}
+
+				int uses = 0;
+
+				for (auto next = ring.begin(); next != ring.end(); ++next)
+				{
+					uses += context.Triangles[*next].HasVertex(other) ? 1 : 0;
+				}
+
+				if (uses == 1)
+				{
+					AddBoundary(context.Positions[vertex], context.Positions[other], plane.Normal, metric);
+				}
+			}
+		}
+	}
+
+	void MemorylessMethod::AddBoundary(const Math::Vec3& pos1, const Math::Vec3& pos2, const Math::Vec3& normal, ErrorMetric& metric) const
+	{
+		Math::Vec3 edge;
+		Math::Vec3::Subtract(edge, pos2, pos1);
+
+		// Plane through edge, perpendicular to its triangle
+		Math::Plane plane;
+		plane.Normal.X = edge.Y * normal.Z - edge.Z * normal.Y;
+		plane.Normal.Y = edge.Z * normal.X - edge.X * normal.Z;
+		plane.Normal.Z = edge.X * normal.Y - edge.Y * normal.X;
+
+		if (!(plane.Normal.Length() > 0.0))
+		{
+			return;
+		}
+
+		plane.Normal.Normalize();
+		plane.D = - (plane.Normal.X * pos1.X + plane.Normal.Y * pos1.Y + plane.Normal.Z * pos1.Z);
+
+		ErrorMetric::Add(metric, metric, ErrorMetric(plane, m_EnableAreaWeights
+			? BoundaryWeight * edge.LengthSquared()
+			: BoundaryWeight));
+	}
+
+	double MemorylessMethod::ComputeError(const MemorylessContext& context, Remesh::VertexId id1, Remesh::VertexId id2, Math::Vec3& error, std::vector<size_t>& ring) const
+	{
+		// Triangles of both vertices, shared ones counted once
+		ErrorMetric edge;
+
+		AddTriangles(context, id1, MemorylessContext::NoVertex, edge, ring);
+		AddTriangles(context, id2, id1, edge, ring);
+
+		if (m_EnableEndpointPlacement)
+		{
+			return edge.MinimizeEndpoints(context.Positions[id1], context.Positions[id2], error);
+		}
+
+		return edge.Minimize(context.Positions[id1], context.Positions[id2], error);
+	}
+
+	bool MemorylessMethod::FlipsTriangles(MemorylessContext& context, Remesh::VertexId vertex, Remesh::VertexId other, const Math::Vec3& position) const
+	{
+		auto& ring = context.Ring;
+
+		ring.clear();
+		GatherTriangles(context, vertex, ring);
+
+		for (auto it = ring.begin(); it != ring.end(); ++it)
+		{
+			auto& triangle = context.Triangles[*it];
+
+			// Triangles of edge itself are removed
+			if (triangle.HasVertex(other))
+			{
+				continue;
+			}
+
+			Math::Vec3 before[3];
+			Math::Vec3 after[3];
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				before[j] = context.Positions[triangle.Vertices[j]];
+				after[j] = (triangle.Vertices[j] == vertex) ? position : before[j];
+			}
+
+			Math::Plane plane1(before[0], before[1], before[2]);
+			Math::Plane plane2(after[0], after[1], after[2]);
+
+			double dot =
+				plane1.Normal.X * plane2.Normal.X +
+				plane1.Normal.Y * plane2.Normal.Y +
+				plane1.Normal.Z * plane2.Normal.Z;
+
+			// Also rejects triangles made degenerate
+			if (!(dot > 0.0))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool MemorylessMethod::CollapseEdge(MemorylessContext& context, EdgeErrorTable::Key key) const
+	{
+		auto& edges = context.Edges;
+		auto& ring = context.Ring;
+		auto& neighbors = context.Neighbors;
+		auto& collapse = context.Collapse;
+
+		Remesh::VertexId kept = (Remesh::VertexId)EdgeErrorTable::GetFirst(key);
+		Remesh::VertexId removed = (Remesh::VertexId)EdgeErrorTable::GetSecond(key);
+
+		Math::Vec3 position;
+		ComputeError(context, kept, removed, position, context.Evaluated);
+
+		// Vertex at chosen endpoint is kept
+		if (m_EnableEndpointPlacement && (position != context.Positions[kept]))
+		{
+			std::swap(kept, removed);
+		}
+
+		// Edge stays out of queue until its neighborhood changes
+		if (FlipsTriangles(context, kept, removed, position) || FlipsTriangles(context, removed, kept, position))
+		{
+			edges.SetError(edges.Find(key), (double)std::numeric_limits<int>::max());
+			return false;
+		}
+
+		// Triangles of removed vertex, reported in input order
+		ring.clear();
+		GatherTriangles(context, removed, ring);
+		std::sort(ring.begin(), ring.end());
+
+		neighbors.clear();
+
+		for (auto it = ring.begin(); it != ring.end(); ++it)
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				auto vertex = context.Triangles[*it].Vertices[j];
+
+				if ((vertex != kept) && (vertex != removed))
+				{
+					neighbors.push_back(vertex);
+				}
+			}
+		}
+
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+		context.Positions[kept] = position;
+
+		collapse.Kept = context.VertexIds[kept];
+		collapse.Removed = context.VertexIds[removed];
+		collapse.Position = position;
+		collapse.RemovedTriangles.clear();
+		collapse.ChangedTriangles.clear();
+
+		for (auto it = ring.begin(); it != ring.end(); ++it)
+		{
+			auto& triangle = context.Triangles[*it];
+
+			if (triangle.HasVertex(kept))
+			{
+				collapse.RemovedTriangles.push_back(*it);
+				context.TriangleAlive[*it] = 0;
+			}
+			else
+			{
+				collapse.ChangedTriangles.push_back(*it);
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					if (triangle.Vertices[j] == removed)
+					{
+						triangle.Vertices[j] = kept;
+					}
+				}
+			}
+		}
+
+		context.TriangleCount -= collapse.RemovedTriangles.size();
+
+		if (context.GetCollapseListener() != nullptr)
+		{
+			context.GetCollapseListener()->OnCollapse(collapse);
+		}
+
+		// Removed vertex hands its triangles over to kept one
+		context.VertexAlive[removed] = 0;
+		context.NextMerged[context.LastMerged[kept]] = removed;
+		context.LastMerged[kept] = context.LastMerged[removed];
+
+		// Edges of kept vertex are recreated from its triangles
+		for (auto it = neighbors.begin(); it != neighbors.end(); ++it)
+		{
+			edges.Erase(EdgeErrorTable::MakeKey(std::min(removed, *it), std::max(removed, *it)));
+		}
+
+		edges.Erase(key);
+
+		UpdateEdges(context, kept);
+		return true;
+	}
+
+	void MemorylessMethod::UpdateEdges(MemorylessContext& context, Remesh::VertexId vertex) const
+	{
+		auto& edges = context.Edges;
+		auto& ring = context.Ring;
+		auto& neighbors = context.Neighbors;
+		auto& keys = context.EdgeKeys;
+
+		ring.clear();
+		GatherTriangles(context, vertex, ring);
+
+		neighbors.clear();
+		neighbors.push_back(vertex);
+
+		for (auto it = ring.begin(); it != ring.end(); ++it)
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				neighbors.push_back(context.Triangles[*it].Vertices[j]);
+			}
+		}
+
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+		// Triangles around vertex changed, so did errors of all edges touching them
+		keys.clear();
+
+		for (auto it = neighbors.begin(); it != neighbors.end(); ++it)
+		{
+			ring.clear();
+			GatherTriangles(context, *it, ring);
+
+			for (auto triangle = ring.begin(); triangle != ring.end(); ++triangle)
+			{
+				for (auto j = 0; j < 3; ++j)
+				{
+					auto other = context.Triangles[*triangle].Vertices[j];
+
+					if (other != *it)
+					{
+						keys.push_back(EdgeErrorTable::MakeKey(std::min(*it, other), std::max(*it, other)));
+					}
+				}
+			}
+		}
+
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+		for (auto it = keys.begin(); it != keys.end(); ++it)
+		{
+			double error = ComputeError(context, *it, context.Evaluated);
+			size_t slot = edges.Find(*it);
+
+			if (slot == EdgeErrorTable::InvalidSlot)
+			{
+				edges.Insert(*it, error);
+				QueueEdge(context, *it, error);
+			}
+			else if (edges.GetError(slot) != error)
+			{
+				edges.SetError(slot, error);
+				QueueEdge(context, *it, error);
+			}
+		}
+	}
+
+	void MemorylessMethod::Remesh(MemorylessContext& context, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener) const
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Remesh");
+		}
+
+		// Visit targets in collapse order - fewest removed triangles first.
+		std::vector<size_t> order;
+
+		for (size_t i = 0; i < targetTriangles.size(); ++i)
+		{
+			order.push_back(i);
+		}
+
+		std::stable_sort(order.begin(), order.end(),
+			[&](size_t lhs, size_t rhs)
+			{
+				return targetTriangles[lhs] < targetTriangles[rhs];
+			});
+
+		size_t totalTriangles = context.TriangleCount;
+		size_t finalTarget = order.empty() ? 0 : targetTriangles[order.back()];
+		size_t level = 0;
+
+		for (;;)
+		{
+			// Emit snapshots for all reached targets.
+			while ((level < order.size()) &&
+				(targetTriangles[order[level]] <= totalTriangles) &&
+				(context.TriangleCount <= totalTriangles - targetTriangles[order[level]]))
+			{
+				EmitSnapshot(context, order[level], snapshots);
+				++level;
+			}
+
+			if (level == order.size())
+			{
+				break;
+			}
+
+			if (listener != nullptr)
+			{
+				ReportStep(listener, totalTriangles - context.TriangleCount, finalTarget);
+			}
+
+			EdgeErrorTable::Key key = PopCheapestEdge(context);
+
+			if (key == NoEdge)
+			{
+				break;
+			}
+
+			if (!CollapseEdge(context, key))
+			{
+				continue;
+			}
+
+			// Drop outdated entries once they outnumber current ones
+			if (context.Queue.size() > 2 * context.Edges.GetSize() + 1024)
+			{
+				RebuildQueue(context);
+			}
+		}
+
+		// Mesh ran out of edges before reaching remaining targets.
+		for (; level < order.size(); ++level)
+		{
+			EmitSnapshot(context, order[level], snapshots);
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Remesh");
+		}
+	}
+}
+}
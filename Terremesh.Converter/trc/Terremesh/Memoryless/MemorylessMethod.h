@@ -0,0 +1,251 @@
+#pragma once
+#ifndef _Terremesh_Memoryless_MemorylessMethod_H__
+#define _Terremesh_Memoryless_MemorylessMethod_H__
+
+#include "../Required.h"
+
+#include "../IProgressListener.h"
+#include "../IRemeshingMethod.h"
+#include "../ISnapshotListener.h"
+#include "../Remesh/Mesh.h"
+#include "../QuadricErrorMetric/ErrorMetric.h"
+#include "MemorylessContext.h"
+
+namespace Terremesh
+{
+namespace Memoryless
+{
+	/// Implementation of memoryless simplification (Lindstrom-Turk).
+	///
+	/// @remarks
+	///		Error of edge is evaluated against planes of triangles currently
+	///		adjacent to its vertices, rebuilt on each evaluation instead of
+	///		being accumulated from input mesh. After each collapse, edges
+	///		around every vertex of the new one-ring are evaluated again.
+	///
+	///		Method keeps no per-job state, all of it lives in context.
+	class MemorylessMethod
+		: public IRemeshingMethod
+	{
+	public:
+		/// Creates instance of the MemorylessMethod class.
+		MemorylessMethod()
+			: m_EnableAreaWeights(false)
+			, m_EnableEndpointPlacement(false)
+		{
+		}
+
+		virtual void Process(Remesh::Mesh& mesh, double targetRatio, IProgressListener* listener);
+		virtual void Process(Remesh::Mesh& mesh, int targetTriangles, IProgressListener* listener);
+		virtual void Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler);
+
+		/// Processes mesh using multiple triangles counts in single pass.
+		///
+		/// @param[in,out] mesh
+		///		The mesh to process. Receives mesh for largest target.
+		/// @param[in] targetTriangles
+		///		The numbers of target triangles.
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] snapshots
+		///		The listener receiving mesh for each target.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler running parallel parts of method, or nullptr.
+		void Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, MemorylessContext& context, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler) const;
+
+		/// Gets value indicating whether plane quadrics are weighted by triangle area.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool GetEnableAreaWeights() const { return m_EnableAreaWeights; }
+
+		/// Sets value indicating whether plane quadrics are weighted by triangle area.
+		///
+		/// @param[in] value
+		///		The value.
+		void SetEnableAreaWeights(bool value) { m_EnableAreaWeights = value; }
+
+		/// Gets value indicating whether merged vertex is placed at one of edge endpoints.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool GetEnableEndpointPlacement() const { return m_EnableEndpointPlacement; }
+
+		/// Sets value indicating whether merged vertex is placed at one of edge endpoints.
+		///
+		/// @param[in] value
+		///		The value.
+		void SetEnableEndpointPlacement(bool value) { m_EnableEndpointPlacement = value; }
+
+	private:
+		/// The key returned when no edge is left.
+		static const QuadricErrorMetric::EdgeErrorTable::Key NoEdge = ~0ULL;
+
+		/// Area weighted plane quadrics.
+		bool m_EnableAreaWeights;
+
+		/// Endpoint placement of merged vertex.
+		bool m_EnableEndpointPlacement;
+
+	private:
+		/// Collects edges of mesh and computes their errors.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] listener
+		///		The progress listener.
+		void Initialize(MemorylessContext& context, IProgressListener* listener) const;
+
+		/// Remeshes mesh.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] targetTriangles
+		///		The numbers of target mesh triangles.
+		/// @param[in] snapshots
+		///		The listener receiving mesh for each target.
+		/// @param[in] listener
+		///		The progress listener.
+		void Remesh(MemorylessContext& context, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener) const;
+
+		/// Emits snapshot of current mesh.
+		///
+		/// @param[in] context
+		///		The job context.
+		/// @param[in] index
+		///		The index of reached target.
+		/// @param[in] snapshots
+		///		The snapshot listener.
+		void EmitSnapshot(const MemorylessContext& context, size_t index, ISnapshotListener* snapshots) const;
+
+		/// Pops cheapest edge whose queued error is still current.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		///
+		/// @return
+		///		The key of edge with lowest error and lowest pair, or NoEdge.
+		QuadricErrorMetric::EdgeErrorTable::Key PopCheapestEdge(MemorylessContext& context) const;
+
+		/// Rebuilds queue from current edge errors, dropping outdated entries.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		void RebuildQueue(MemorylessContext& context) const;
+
+		/// Collapses edge, keeping its first vertex or the one at chosen endpoint.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] key
+		///		The edge key.
+		///
+		/// @retval true when successful.
+		/// @retval false when collapse would flip triangles.
+		bool CollapseEdge(MemorylessContext& context, QuadricErrorMetric::EdgeErrorTable::Key key) const;
+
+		/// Checks whether moving vertex flips any of its triangles.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] vertex
+		///		The moved vertex index.
+		/// @param[in] other
+		///		The other vertex of collapsed edge.
+		/// @param[in] position
+		///		The new position.
+		///
+		/// @retval true when triangle is flipped or degenerated.
+		/// @retval false otherwise.
+		bool FlipsTriangles(MemorylessContext& context, Remesh::VertexId vertex, Remesh::VertexId other, const Math::Vec3& position) const;
+
+		/// Evaluates edges of all triangles around vertex and its neighbors.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] vertex
+		///		The vertex index.
+		void UpdateEdges(MemorylessContext& context, Remesh::VertexId vertex) const;
+
+		/// Appends present triangles adjacent to vertex.
+		///
+		/// @param[in] context
+		///		The job context.
+		/// @param[in] vertex
+		///		The vertex index.
+		/// @param[out] triangles
+		///		The triangle indices.
+		void GatherTriangles(const MemorylessContext& context, Remesh::VertexId vertex, std::vector<size_t>& triangles) const;
+
+		/// Adds plane quadrics of present triangles adjacent to vertex.
+		///
+		/// @param[in] context
+		///		The job context.
+		/// @param[in] vertex
+		///		The vertex index.
+		/// @param[in] skipped
+		///		The vertex whose triangles are skipped, or NoVertex.
+		/// @param[in,out] metric
+		///		The error metric receiving plane quadrics.
+		/// @param[out] ring
+		///		The buffer receiving triangles adjacent to vertex.
+		///
+		/// @remarks
+		///		Boundary edges of vertex add planes perpendicular to their triangles.
+		void AddTriangles(const MemorylessContext& context, Remesh::VertexId vertex, Remesh::VertexId skipped, QuadricErrorMetric::ErrorMetric& metric, std::vector<size_t>& ring) const;
+
+		/// Adds plane keeping boundary edge in place.
+		///
+		/// @param[in] pos1
+		///		The first edge point.
+		/// @param[in] pos2
+		///		The second edge point.
+		/// @param[in] normal
+		///		The normal of triangle.
+		/// @param[in,out] metric
+		///		The error metric receiving plane quadric.
+		void AddBoundary(const Math::Vec3& pos1, const Math::Vec3& pos2, const Math::Vec3& normal, QuadricErrorMetric::ErrorMetric& metric) const;
+
+		/// Computes error for vertices pair.
+		///
+		/// @param[in] context
+		///		The job context.
+		/// @param[in] id1
+		///		The vertex index.
+		/// @param[in] id2
+		///		The vertex index.
+		/// @param[out] error
+		///		The error point.
+		/// @param[out] ring
+		///		The buffer for adjacent triangles.
+		///
+		/// @returns
+		///		The error value.
+		double ComputeError(const MemorylessContext& context, Remesh::VertexId id1, Remesh::VertexId id2, Math::Vec3& error, std::vector<size_t>& ring) const;
+
+		/// Computes error for vertices pair.
+		///
+		/// @param[in] context
+		///		The job context.
+		/// @param[in] key
+		///		The edge key.
+		/// @param[out] ring
+		///		The buffer for adjacent triangles.
+		///
+		/// @returns
+		///		The error value.
+		double ComputeError(const MemorylessContext& context, QuadricErrorMetric::EdgeErrorTable::Key key, std::vector<size_t>& ring) const
+		{
+			Math::Vec3 error;
+			return ComputeError(context,
+				(Remesh::VertexId)QuadricErrorMetric::EdgeErrorTable::GetFirst(key),
+				(Remesh::VertexId)QuadricErrorMetric::EdgeErrorTable::GetSecond(key),
+				error, ring);
+		}
+	};
+}
+}
+
+#endif /* _Terremesh_Memoryless_MemorylessMethod_H__ */
@@ -0,0 +1,187 @@
+#include "EdgeErrorTable.h"
+
+namespace Terremesh
+{
+namespace QuadricErrorMetric
+{
+	/// The minimal number of slots.
+	static const size_t MinCapacity = 16;
+
+	EdgeErrorTable::EdgeErrorTable()
+		: m_Size(0)
+		, m_Shift(64)
+	{
+	}
+
+	size_t EdgeErrorTable::Find(Key key) const
+	{
+		if (m_Size == 0)
+		{
+			return InvalidSlot;
+		}
+
+		size_t mask = m_Keys.size() - 1;
+		size_t slot = GetHome(key);
+
+		// Entries further from home than probed key cannot be followed by it
+		for (unsigned int distance = 1; m_Distances[slot] >= distance; ++distance)
+		{
+			if (m_Keys[slot] == key)
+			{
+				return slot;
+			}
+
+			slot = (slot + 1) & mask;
+		}
+
+		return InvalidSlot;
+	}
+
+	bool EdgeErrorTable::Insert(Key key, double error)
+	{
+		if (Find(key) != InvalidSlot)
+		{
+			return false;
+		}
+
+		Reserve(m_Size + 1);
+		Place(key, error);
+
+		return true;
+	}
+
+	void EdgeErrorTable::InsertBatch(const Key* keys, size_t count, double error)
+	{
+		// Edges of closed mesh are listed twice, by both of their triangles
+		Reserve(m_Size + count / 2);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (Find(keys[i]) == InvalidSlot)
+			{
+				Reserve(m_Size + 1);
+				Place(keys[i], error);
+			}
+		}
+	}
+
+	bool EdgeErrorTable::Erase(Key key)
+	{
+		size_t slot = Find(key);
+
+		if (slot == InvalidSlot)
+		{
+			return false;
+		}
+
+		size_t mask = m_Keys.size() - 1;
+		size_t next = (slot + 1) & mask;
+
+		// Shift following entries one slot closer to their homes
+		while (m_Distances[next] > 1)
+		{
+			m_Keys[slot] = m_Keys[next];
+			m_Errors[slot] = m_Errors[next];
+			m_Distances[slot] = m_Distances[next] - 1;
+
+			slot = next;
+			next = (next + 1) & mask;
+		}
+
+		m_Errors[slot] = std::numeric_limits<double>::infinity();
+		m_Distances[slot] = 0;
+		--m_Size;
+
+		return true;
+	}
+
+	void EdgeErrorTable::Reserve(size_t count)
+	{
+		// Keep load factor at most 80%
+		size_t capacity = std::max(m_Keys.size(), MinCapacity);
+
+		while (count * 5 > capacity * 4)
+		{
+			capacity *= 2;
+		}
+
+		if (capacity != m_Keys.size())
+		{
+			Rehash(capacity);
+		}
+	}
+
+	void EdgeErrorTable::Clear()
+	{
+		std::fill(m_Errors.begin(), m_Errors.end(), std::numeric_limits<double>::infinity());
+		std::fill(m_Distances.begin(), m_Distances.end(), 0);
+		m_Size = 0;
+	}
+
+	void EdgeErrorTable::Release()
+	{
+		std::vector<Key>().swap(m_Keys);
+		std::vector<double>().swap(m_Errors);
+		std::vector<unsigned int>().swap(m_Distances);
+		m_Size = 0;
+		m_Shift = 64;
+	}
+
+	void EdgeErrorTable::Place(Key key, double error)
+	{
+		size_t mask = m_Keys.size() - 1;
+		size_t slot = GetHome(key);
+		unsigned int distance = 1;
+
+		for (;;)
+		{
+			if (m_Distances[slot] == 0)
+			{
+				m_Keys[slot] = key;
+				m_Errors[slot] = error;
+				m_Distances[slot] = distance;
+				++m_Size;
+				return;
+			}
+
+			// Take slot from entry closer to its home and carry it further
+			if (m_Distances[slot] < distance)
+			{
+				std::swap(m_Keys[slot], key);
+				std::swap(m_Errors[slot], error);
+				std::swap(m_Distances[slot], distance);
+			}
+
+			slot = (slot + 1) & mask;
+			++distance;
+		}
+	}
+
+	void EdgeErrorTable::Rehash(size_t capacity)
+	{
+		std::vector<Key> keys(capacity);
+		std::vector<double> errors(capacity, std::numeric_limits<double>::infinity());
+		std::vector<unsigned int> distances(capacity, 0);
+
+		keys.swap(m_Keys);
+		errors.swap(m_Errors);
+		distances.swap(m_Distances);
+
+		m_Size = 0;
+		m_Shift = 64;
+
+		for (size_t bits = capacity; bits > 1; bits >>= 1)
+		{
+			--m_Shift;
+		}
+
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			if (distances[i] != 0)
+			{
+				Place(keys[i], errors[i]);
+			}
+		}
+	}
+}
+}
@@ -0,0 +1,158 @@
+#pragma once
+#ifndef _Terremesh_QuadricErrorMetric_EdgeErrorTable_H__
+#define _Terremesh_QuadricErrorMetric_EdgeErrorTable_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace QuadricErrorMetric
+{
+	/// Implements open-addressing hash table of vertex pair errors.
+	///
+	/// @remarks
+	///		Pairs are packed into 64-bit keys and placed using robin-hood
+	///		probing. Erase shifts following entries back, so table never holds
+	///		tombstones. Entries are addressed by slot, which is stable only
+	///		until next insert or erase. Empty slots report infinite error, so
+	///		minimum error may be searched without testing slot occupancy.
+	class EdgeErrorTable
+	{
+	public:
+		/// The packed vertex pair type.
+		typedef unsigned long long Key;
+
+		/// The invalid slot.
+		static const size_t InvalidSlot = (size_t)-1;
+
+		/// Creates instance of the EdgeErrorTable class.
+		EdgeErrorTable();
+
+		/// Packs vertex pair into key.
+		///
+		/// @param[in] first
+		///		The first vertex index.
+		/// @param[in] second
+		///		The second vertex index.
+		///
+		/// @return
+		///		The key. Keys order the same as pairs.
+		static Key MakeKey(unsigned int first, unsigned int second) { return ((Key)first << 32) | (Key)second; }
+
+		/// Gets first vertex index of key.
+		static unsigned int GetFirst(Key key) { return (unsigned int)(key >> 32); }
+
+		/// Gets second vertex index of key.
+		static unsigned int GetSecond(Key key) { return (unsigned int)key; }
+
+		/// Gets number of entries.
+		size_t GetSize() const { return m_Size; }
+
+		/// Determines whether table is empty.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool IsEmpty() const { return m_Size == 0; }
+
+		/// Gets number of slots.
+		size_t GetCapacity() const { return m_Keys.size(); }
+
+		/// Determines whether slot holds entry.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool IsOccupied(size_t slot) const { return m_Distances[slot] != 0; }
+
+		/// Gets key of slot.
+		Key GetKey(size_t slot) const { return m_Keys[slot]; }
+
+		/// Gets error of slot.
+		double GetError(size_t slot) const { return m_Errors[slot]; }
+
+		/// Sets error of occupied slot.
+		void SetError(size_t slot, double value) { m_Errors[slot] = value; }
+
+		/// Finds slot of key.
+		///
+		/// @param[in] key
+		///		The key.
+		///
+		/// @return
+		///		The slot or InvalidSlot.
+		size_t Find(Key key) const;
+
+		/// Inserts entry unless key is present.
+		///
+		/// @param[in] key
+		///		The key.
+		/// @param[in] error
+		///		The error.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Insert(Key key, double error);
+
+		/// Inserts entries of absent keys, all with the same error.
+		///
+		/// @remarks
+		///		Slots are reserved for half of keys upfront, as edges of closed
+		///		mesh are shared by two triangles.
+		///
+		/// @param[in] keys
+		///		The keys, duplicates allowed.
+		/// @param[in] count
+		///		The number of keys.
+		/// @param[in] error
+		///		The error.
+		void InsertBatch(const Key* keys, size_t count, double error);
+
+		/// Erases entry.
+		///
+		/// @param[in] key
+		///		The key.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Erase(Key key);
+
+		/// Ensures that table holds count entries without growing.
+		///
+		/// @param[in] count
+		///		The number of entries.
+		void Reserve(size_t count);
+
+		/// Removes all entries, keeping allocated slots.
+		void Clear();
+
+		/// Removes all entries and releases slots.
+		void Release();
+
+	private:
+		/// Computes home slot of key.
+		size_t GetHome(Key key) const { return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> m_Shift); }
+
+		/// Places absent key, displacing entries closer to their home slots.
+		void Place(Key key, double error);
+
+		/// Rebuilds table with given number of slots.
+		void Rehash(size_t capacity);
+
+		/// Keys, by slot.
+		std::vector<Key> m_Keys;
+
+		/// Errors, by slot. Infinite for empty slots.
+		std::vector<double> m_Errors;
+
+		/// Probe distances increased by one, by slot. Zero for empty slots.
+		std::vector<unsigned int> m_Distances;
+
+		/// The number of entries.
+		size_t m_Size;
+
+		/// The shift selecting high bits of hash.
+		int m_Shift;
+	};
+}
+}
+
+#endif /* _Terremesh_QuadricErrorMetric_EdgeErrorTable_H__ */
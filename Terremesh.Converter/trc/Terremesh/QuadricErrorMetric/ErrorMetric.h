@@ -44,6 +44,22 @@ namespace QuadricErrorMetric
                 ad, bd, cd, dd);
 		}
 
+		/// Creates instance of the ErrorMetric class weighted by factor.
+		///
+		/// @param[in] plane
+		///		The plane.
+		/// @param[in] weight
+		///		The weight, usually area of triangle.
+		ErrorMetric(Math::Plane plane, double weight)
+		{
+			*this = ErrorMetric(plane);
+
+			for (auto i = 0; i < 16; ++i)
+			{
+				m_Matrix.m[i] *= weight;
+			}
+		}
+
 		/// Evaluates error metric for specified point.
 		///
 		/// @param[in] point
@@ -63,6 +79,97 @@ namespace QuadricErrorMetric
 				m_Matrix.m[15];
 		}
 
+		/// Finds point with lowest error.
+		///
+		/// @param[in] point1
+		///		The first edge point.
+		/// @param[in] point2
+		///		The second edge point.
+		/// @param[out] point
+		///		The point with lowest error.
+		///
+		/// @return
+		///		The error value.
+		///
+		/// @remarks
+		///		When matrix is not invertible, best of edge points and their center is chosen.
+		double Minimize(const Math::Vec3& point1, const Math::Vec3& point2, Math::Vec3& point)
+		{
+			Math::Vec3 vertex;
+
+			// Compute delta matrix
+			Math::Matrix delta = m_Matrix;
+			{
+				delta.M41 = 0.0;
+				delta.M42 = 0.0;
+				delta.M43 = 0.0;
+				delta.M44 = 1.0;
+			}
+
+			// If matrix is not invertible
+			if (std::abs(delta.Determinant()) <= 1e-5)
+			{
+				// Take two vertices and center between them
+				Math::Vec3 center;
+				Math::Vec3::Center(center, point1, point2);
+
+				// And evaluate costs
+				double e1 = Evaluate(point1);
+				double e2 = Evaluate(point2);
+				double e3 = Evaluate(center);
+
+				// And choose wisely
+				double minError = std::min(std::min(e1, e2), e3);
+
+				if (minError == e1)
+				{
+					vertex = point1;
+				}
+				else if (minError == e2)
+				{
+					vertex = point2;
+				}
+				else if (minError == e3)
+				{
+					vertex = center;
+				}
+			}
+			else
+			{
+				// Otherwise compute vertex from matrix.
+				vertex = delta.GetVector();
+			}
+
+			point = vertex;
+			return Evaluate(vertex);
+		}
+
+		/// Finds edge point with lowest error.
+		///
+		/// @param[in] point1
+		///		The first edge point.
+		/// @param[in] point2
+		///		The second edge point.
+		/// @param[out] point
+		///		The edge point with lowest error, first one on tie.
+		///
+		/// @return
+		///		The error value.
+		double MinimizeEndpoints(const Math::Vec3& point1, const Math::Vec3& point2, Math::Vec3& point)
+		{
+			double e1 = Evaluate(point1);
+			double e2 = Evaluate(point2);
+
+			if (e2 < e1)
+			{
+				point = point2;
+				return e2;
+			}
+
+			point = point1;
+			return e1;
+		}
+
 		/// Gets matrix.
 		///
 		/// @return
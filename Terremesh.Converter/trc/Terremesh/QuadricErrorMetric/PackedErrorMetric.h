@@ -0,0 +1,100 @@
+#pragma once
+#ifndef _Terremesh_QuadricErrorMetric_PackedErrorMetric_H__
+#define _Terremesh_QuadricErrorMetric_PackedErrorMetric_H__
+
+#include "../Required.h"
+#include "ErrorMetric.h"
+
+namespace Terremesh
+{
+namespace QuadricErrorMetric
+{
+	/// Implements storage of error metric with chosen precision.
+	///
+	/// @remarks
+	///		Quadric matrix is symmetric, so only its upper triangle of ten
+	///		coefficients is stored. Sums are computed in double precision.
+	template <typename TScalar>
+	class PackedErrorMetric
+	{
+	public:
+		/// Creates instance of the PackedErrorMetric class.
+		PackedErrorMetric()
+		{
+			for (auto i = 0; i < 10; ++i)
+			{
+				m_Values[i] = 0;
+			}
+		}
+
+		/// Creates instance of the PackedErrorMetric class.
+		///
+		/// @param[in] metric
+		///		The source error metric.
+		PackedErrorMetric(const ErrorMetric& metric)
+		{
+			auto& matrix = metric.GetMatrix();
+
+			for (auto i = 0; i < 10; ++i)
+			{
+				m_Values[i] = (TScalar)matrix.m[GetRow(i) * 4 + GetColumn(i)];
+			}
+		}
+
+		/// Converts to double precision error metric.
+		///
+		/// @return
+		///		The error metric.
+		ErrorMetric ToErrorMetric() const
+		{
+			Math::Matrix matrix;
+
+			for (auto i = 0; i < 10; ++i)
+			{
+				matrix.m[GetRow(i) * 4 + GetColumn(i)] = m_Values[i];
+				matrix.m[GetColumn(i) * 4 + GetRow(i)] = m_Values[i];
+			}
+
+			ErrorMetric result;
+			result.SetMatrix(matrix);
+			return result;
+		}
+
+		/// Adds value1 to value2 and store into result.
+		///
+		/// @param[out] result
+		///		The return error metric.
+		/// @param[in] value1
+		///		The source error metric.
+		/// @param[in] value2
+		///		The source error metric.
+		static void Add(PackedErrorMetric& result, const PackedErrorMetric& value1, const PackedErrorMetric& value2)
+		{
+			for (auto i = 0; i < 10; ++i)
+			{
+				result.m_Values[i] = (TScalar)((double)value1.m_Values[i] + (double)value2.m_Values[i]);
+			}
+		}
+
+	private:
+		/// Gets row of upper triangle coefficient.
+		static int GetRow(int index)
+		{
+			static const int rows[10] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 3 };
+			return rows[index];
+		}
+
+		/// Gets column of upper triangle coefficient.
+		static int GetColumn(int index)
+		{
+			static const int columns[10] = { 0, 1, 2, 3, 1, 2, 3, 2, 3, 3 };
+			return columns[index];
+		}
+
+		/// The upper triangle coefficients, by rows.
+		TScalar m_Values[10];
+	};
+}
+}
+
+#endif /* _Terremesh_QuadricErrorMetric_PackedErrorMetric_H__ */
@@ -0,0 +1,219 @@
+#include "QuadricErrorMetricContext.h"
+
+namespace Terremesh
+{
+namespace QuadricErrorMetric
+{
+	template <typename TScalar, typename TIndex>
+	void BasicQuadricErrorMetricContext<TScalar, TIndex>::Load(const Remesh::Mesh& mesh)
+	{
+		Clear();
+
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		// Vertex IDs are sorted, so vertex indices preserve their order
+		if (!vertices.empty())
+		{
+			VertexIndices.resize((size_t)vertices.rbegin()->first + 1, InvalidIndex);
+		}
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			VertexIndices[it->first] = (TIndex)Vertices.size();
+			Vertices.push_back(it->second);
+			VertexIds.push_back(it->first);
+		}
+
+		VertexAlive.resize(Vertices.size(), 1);
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it)
+		{
+			PackedTriangle<TIndex> triangle;
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				triangle.Vertices[j] = VertexIndices[it->Vertices[j]];
+			}
+
+			TriangleIndices.push_back(Triangles.size());
+			Triangles.push_back(triangle);
+		}
+
+		TriangleAlive.resize(Triangles.size(), 1);
+		TriangleCount = Triangles.size();
+	}
+
+	template <typename TScalar, typename TIndex>
+	void BasicQuadricErrorMetricContext<TScalar, TIndex>::Store(Remesh::Mesh& mesh) const
+	{
+		Remesh::Mesh::VertexContainer vertices;
+		Remesh::Mesh::TriangleContainer triangles;
+
+		for (size_t i = 0; i < Vertices.size(); ++i)
+		{
+			if (VertexAlive[i])
+			{
+				vertices.insert(vertices.end(), std::make_pair(VertexIds[i], Remesh::Vertex(Vertices[i].Position)));
+			}
+		}
+
+		for (size_t i = 0; i < Triangles.size(); ++i)
+		{
+			if (TriangleAlive[i])
+			{
+				Remesh::Triangle triangle;
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					triangle.Vertices[j] = VertexIds[Triangles[i].Vertices[j]];
+				}
+
+				triangles.push_back(triangle);
+			}
+		}
+
+		mesh.SetVertices(vertices);
+		mesh.SetTriangles(triangles);
+	}
+
+	template <typename TScalar, typename TIndex>
+	void BasicQuadricErrorMetricContext<TScalar, TIndex>::Clear()
+	{
+		Vertices.clear();
+		VertexIds.clear();
+		VertexIndices.clear();
+		VertexAlive.clear();
+		Triangles.clear();
+		TriangleIndices.clear();
+		TriangleAlive.clear();
+		TriangleCount = 0;
+		VertexTriangleOffsets.clear();
+		VertexTriangles.clear();
+		Planes.clear();
+		Areas.clear();
+		ErrorMetrics.clear();
+		Edges.Clear();
+		EdgeKeys.clear();
+		MovedVertices.clear();
+		Collapse.RemovedTriangles.clear();
+		Collapse.ChangedTriangles.clear();
+		Scheduler = nullptr;
+	}
+
+	/// Releases memory of vector beyond its size.
+	template <typename T>
+	static void ShrinkToFit(std::vector<T>& values)
+	{
+		std::vector<T>(values.begin(), values.end()).swap(values);
+	}
+
+	template <typename TScalar, typename TIndex>
+	void BasicQuadricErrorMetricContext<TScalar, TIndex>::Compact()
+	{
+		// Renumber present vertices
+		std::vector<TIndex> indices(Vertices.size(), InvalidIndex);
+		size_t vertices = 0;
+
+		for (size_t i = 0; i < Vertices.size(); ++i)
+		{
+			if (VertexAlive[i])
+			{
+				indices[i] = (TIndex)vertices;
+				VertexIndices[VertexIds[i]] = (TIndex)vertices;
+
+				Vertices[vertices] = Vertices[i];
+				VertexIds[vertices] = VertexIds[i];
+				ErrorMetrics[vertices] = ErrorMetrics[i];
+				++vertices;
+			}
+			else
+			{
+				VertexIndices[VertexIds[i]] = InvalidIndex;
+			}
+		}
+
+		Vertices.resize(vertices);
+		VertexIds.resize(vertices);
+		ErrorMetrics.resize(vertices);
+		VertexAlive.assign(vertices, 1);
+
+		// Renumber present triangles
+		size_t triangles = 0;
+
+		for (size_t i = 0; i < Triangles.size(); ++i)
+		{
+			if (TriangleAlive[i])
+			{
+				PackedTriangle<TIndex> triangle = Triangles[i];
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					triangle.Vertices[j] = indices[triangle.Vertices[j]];
+				}
+
+				Triangles[triangles] = triangle;
+				TriangleIndices[triangles] = TriangleIndices[i];
+				++triangles;
+			}
+		}
+
+		Triangles.resize(triangles);
+		TriangleIndices.resize(triangles);
+		TriangleAlive.assign(triangles, 1);
+
+		// Renumbering keeps vertex order, so keys keep their order too
+		std::vector<EdgeErrorTable::Key> keys;
+		std::vector<double> errors;
+
+		keys.reserve(Edges.GetSize());
+		errors.reserve(Edges.GetSize());
+
+		for (size_t i = 0; i < Edges.GetCapacity(); ++i)
+		{
+			if (Edges.IsOccupied(i))
+			{
+				auto key = Edges.GetKey(i);
+
+				keys.push_back(EdgeErrorTable::MakeKey(
+					indices[EdgeErrorTable::GetFirst(key)],
+					indices[EdgeErrorTable::GetSecond(key)]));
+				errors.push_back(Edges.GetError(i));
+			}
+		}
+
+		Edges.Release();
+		Edges.Reserve(keys.size());
+
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			Edges.Insert(keys[i], errors[i]);
+		}
+
+		// Adjacency and planes are needed by initialization only
+		VertexTriangleOffsets.clear();
+		VertexTriangles.clear();
+		Planes.clear();
+		Areas.clear();
+
+		ShrinkToFit(Vertices);
+		ShrinkToFit(VertexIds);
+		ShrinkToFit(VertexAlive);
+		ShrinkToFit(ErrorMetrics);
+		ShrinkToFit(Triangles);
+		ShrinkToFit(TriangleIndices);
+		ShrinkToFit(TriangleAlive);
+		ShrinkToFit(VertexTriangleOffsets);
+		ShrinkToFit(VertexTriangles);
+		ShrinkToFit(Planes);
+		ShrinkToFit(Areas);
+		ShrinkToFit(EdgeKeys);
+		ShrinkToFit(MovedVertices);
+	}
+
+	template class BasicQuadricErrorMetricContext<float, unsigned short>;
+	template class BasicQuadricErrorMetricContext<float, unsigned int>;
+	template class BasicQuadricErrorMetricContext<double, unsigned short>;
+	template class BasicQuadricErrorMetricContext<double, unsigned int>;
+}
+}
@@ -0,0 +1,232 @@
+#pragma once
+#ifndef _Terremesh_QuadricErrorMetric_QuadricErrorMetricContext_H__
+#define _Terremesh_QuadricErrorMetric_QuadricErrorMetricContext_H__
+
+#include "../Required.h"
+
+#include "../ICollapseListener.h"
+#include "../Remesh/Mesh.h"
+#include "../Remesh/EdgeCollapse.h"
+#include "../Threading/TaskScheduler.h"
+#include "../Math/PackedVec3.h"
+#include "EdgeErrorTable.h"
+#include "ErrorMetric.h"
+#include "PackedErrorMetric.h"
+
+namespace Terremesh
+{
+namespace QuadricErrorMetric
+{
+	/// Describes vertex stored with chosen precision.
+	template <typename TScalar>
+	struct PackedVertex
+	{
+	public:
+		/// Creates instance of the PackedVertex structure.
+		PackedVertex()
+		{
+		}
+
+		/// Creates instance of the PackedVertex structure.
+		///
+		/// @param[in] vertex
+		///		The source vertex.
+		PackedVertex(const Remesh::Vertex& vertex)
+			: Position(vertex.Position)
+		{
+		}
+
+		/// The vertex position.
+		Math::PackedVec3<TScalar> Position;
+	};
+
+	/// Describes triangle referencing vertices by index of chosen width.
+	template <typename TIndex>
+	struct PackedTriangle
+	{
+	public:
+		/// Checks whether triangle references vertex.
+		///
+		/// @param[in] index
+		///		The vertex index.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool HasVertex(size_t index) const
+		{
+			return Vertices[0] == index || Vertices[1] == index || Vertices[2] == index;
+		}
+
+		/// The vertex indices.
+		TIndex Vertices[3];
+	};
+
+	/// Implements per-job state of Quadric Error Metric method.
+	///
+	/// @remarks
+	///		Vertices and triangles are addressed by dense indices instead of
+	///		mesh vertex IDs and input mesh indices. Compaction renumbers them,
+	///		preserving their order. Containers keep their
+	///		capacity between jobs, so context should be reused by consecutive
+	///		jobs running on the same thread. Context must not be shared by
+	///		concurrently running jobs.
+	///
+	///		Positions and error metrics are stored with TScalar precision,
+	///		while all computations on them are done in double precision.
+	///		Vertex indices are stored as TIndex, so mesh must have fewer
+	///		vertices than InvalidIndex. Context is instantiated for float and
+	///		double scalars with 16-bit and 32-bit indices.
+	template <typename TScalar, typename TIndex>
+	class BasicQuadricErrorMetricContext
+	{
+	public:
+		/// The storage scalar type.
+		typedef TScalar Scalar;
+
+		/// The vertex index type.
+		typedef TIndex Index;
+
+		/// The index of missing vertex.
+		static const TIndex InvalidIndex = (TIndex)~(TIndex)0;
+
+		/// The vertex pair type.
+		typedef std::pair<size_t, size_t> VertexPair;
+
+		/// The edge error container type.
+		typedef EdgeErrorTable EdgeErrorContainer;
+
+		/// Creates instance of the BasicQuadricErrorMetricContext class.
+		BasicQuadricErrorMetricContext()
+			: TriangleCount(0)
+			, Scheduler(nullptr)
+			, m_CollapseListener(nullptr)
+		{
+		}
+
+		/// Checks whether context can index vertices of mesh.
+		///
+		/// @param[in] mesh
+		///		The mesh.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		static bool CanIndex(const Remesh::Mesh& mesh)
+		{
+			return mesh.GetVertices().size() < (size_t)InvalidIndex;
+		}
+
+		/// Loads mesh into context.
+		///
+		/// @param[in] mesh
+		///		The mesh.
+		void Load(const Remesh::Mesh& mesh);
+
+		/// Stores remaining vertices and triangles into mesh.
+		///
+		/// @param[out] mesh
+		///		The mesh.
+		void Store(Remesh::Mesh& mesh) const;
+
+		/// Removes all state, keeping allocated capacity.
+		void Clear();
+
+		/// Drops removed vertices, triangles and their data, renumbering
+		/// remaining ones in order, and releases unused memory.
+		///
+		/// @remarks
+		///		Edges must reference present vertices only.
+		void Compact();
+
+		/// Gets listener receiving performed collapses.
+		///
+		/// @return
+		///		The collapse listener.
+		ICollapseListener* GetCollapseListener() const { return m_CollapseListener; }
+
+		/// Sets listener receiving performed collapses.
+		///
+		/// @param[in] value
+		///		The collapse listener or nullptr.
+		void SetCollapseListener(ICollapseListener* value) { m_CollapseListener = value; }
+
+	public:
+		/// Vertices, by vertex index.
+		std::vector<PackedVertex<TScalar> > Vertices;
+
+		/// Mesh vertex IDs, by vertex index.
+		std::vector<Remesh::VertexId> VertexIds;
+
+		/// Vertex indices, by mesh vertex ID.
+		std::vector<TIndex> VertexIndices;
+
+		/// Vertex presence flags.
+		std::vector<char> VertexAlive;
+
+		/// Triangles referencing vertex indices, by triangle index.
+		std::vector<PackedTriangle<TIndex> > Triangles;
+
+		/// Input mesh indices, by triangle index.
+		std::vector<size_t> TriangleIndices;
+
+		/// Triangle presence flags.
+		std::vector<char> TriangleAlive;
+
+		/// The number of present triangles.
+		size_t TriangleCount;
+
+		/// Offsets of vertex entries in VertexTriangles, by vertex index.
+		std::vector<size_t> VertexTriangleOffsets;
+
+		/// Input triangles adjacent to vertex, in triangle order.
+		std::vector<size_t> VertexTriangles;
+
+		/// Triangle planes, by triangle index. Filled during initialization.
+		std::vector<Math::Plane> Planes;
+
+		/// Triangle areas, by triangle index. Filled for area weighted quadrics.
+		std::vector<double> Areas;
+
+		/// Error metrics, by vertex index.
+		std::vector<PackedErrorMetric<TScalar> > ErrorMetrics;
+
+		/// Edge errors.
+		EdgeErrorContainer Edges;
+
+		/// Edge keys being inserted or updated.
+		std::vector<EdgeErrorTable::Key> EdgeKeys;
+
+		/// Vertices whose edges are moved to kept vertex of collapse.
+		std::vector<TIndex> MovedVertices;
+
+		/// Collapse being performed.
+		Remesh::EdgeCollapse Collapse;
+
+		/// Partial collapses of triangle ranges scanned in parallel.
+		std::vector<Remesh::EdgeCollapse> CollapseChunks;
+
+		/// The scheduler running parallel parts of job, or nullptr.
+		Threading::TaskScheduler* Scheduler;
+
+	private:
+		BasicQuadricErrorMetricContext(const BasicQuadricErrorMetricContext&);
+		BasicQuadricErrorMetricContext& operator = (const BasicQuadricErrorMetricContext&);
+
+		/// Collapse listener.
+		ICollapseListener* m_CollapseListener;
+	};
+
+	template <typename TScalar, typename TIndex>
+	const TIndex BasicQuadricErrorMetricContext<TScalar, TIndex>::InvalidIndex;
+
+	/// The context storing data in double precision.
+	typedef BasicQuadricErrorMetricContext<double, unsigned int> QuadricErrorMetricContext;
+
+	/// The context storing data in single precision.
+	typedef BasicQuadricErrorMetricContext<float, unsigned int> FloatQuadricErrorMetricContext;
+
+	/// The context storing data in double precision, for meshes with fewer than 65535 vertices.
+	typedef BasicQuadricErrorMetricContext<double, unsigned short> SmallQuadricErrorMetricContext;
+}
+}
+
+#endif /* _Terremesh_QuadricErrorMetric_QuadricErrorMetricContext_H__ */
@@ -1,71 +1,242 @@
 #include "QuadricErrorMetricMethod.h"
 
 #include "../Math/Matrix.h"
+#include "../Math/Plane.h"
 #include "../Math/Vec3.h"
 
 namespace Terremesh
 {
 namespace QuadricErrorMetric
 {
+	/// The minimal number of triangles worth compacting.
+	static const size_t MinCompactedTriangles = 1024;
+
+	/// The number of triangles whose planes are computed together.
+	static const size_t PlaneBlockSize = 256;
+
+	/// Reports progress of collapses.
+	///
+	/// @remarks
+	///		Listener takes int counts, so counts beyond its range are scaled down.
+	static void ReportStep(IProgressListener* listener, size_t current, size_t total)
+	{
+		while (total > (size_t)std::numeric_limits<int>::max())
+		{
+			current >>= 1;
+			total >>= 1;
+		}
+
+		listener->OnStep((int)current, (int)total);
+	}
+
+	/// Computes planes and areas of block of triangles.
+	///
+	/// @remarks
+	///		Corners are gathered into separate coordinate arrays first, so the
+	///		arithmetic runs as branch-free loops the compiler vectorizes. The
+	///		operations match Math::Plane exactly.
+	template <typename TContext>
+	static void ComputePlaneBlock(const TContext& context, size_t begin, size_t end, Math::Plane* planes, double* areas)
+	{
+		double x1[PlaneBlockSize], y1[PlaneBlockSize], z1[PlaneBlockSize];
+		double ax[PlaneBlockSize], ay[PlaneBlockSize], az[PlaneBlockSize];
+		double bx[PlaneBlockSize], by[PlaneBlockSize], bz[PlaneBlockSize];
+		double nx[PlaneBlockSize], ny[PlaneBlockSize], nz[PlaneBlockSize];
+		double length[PlaneBlockSize];
+
+		size_t count = end - begin;
+
+		for (size_t k = 0; k < count; ++k)
+		{
+			auto& triangle = context.Triangles[begin + k];
+			Math::Vec3 pos1 = context.Vertices[triangle.Vertices[0]].Position;
+			Math::Vec3 pos2 = context.Vertices[triangle.Vertices[1]].Position;
+			Math::Vec3 pos3 = context.Vertices[triangle.Vertices[2]].Position;
+
+			x1[k] = pos1.X;
+			y1[k] = pos1.Y;
+			z1[k] = pos1.Z;
+			ax[k] = pos2.X - pos1.X;
+			ay[k] = pos2.Y - pos1.Y;
+			az[k] = pos2.Z - pos1.Z;
+			bx[k] = pos3.X - pos1.X;
+			by[k] = pos3.Y - pos1.Y;
+			bz[k] = pos3.Z - pos1.Z;
+		}
+
+		for (size_t k = 0; k < count; ++k)
+		{
+			nx[k] = ay[k] * bz[k] - az[k] * by[k];
+			ny[k] = az[k] * bx[k] - ax[k] * bz[k];
+			nz[k] = ax[k] * by[k] - ay[k] * bx[k];
+			length[k] = std::sqrt(nx[k] * nx[k] + ny[k] * ny[k] + nz[k] * nz[k]);
+		}
+
+		for (size_t k = 0; k < count; ++k)
+		{
+			double invLength = 1.0 / length[k];
+
+			nx[k] *= invLength;
+			ny[k] *= invLength;
+			nz[k] *= invLength;
+		}
+
+		for (size_t k = 0; k < count; ++k)
+		{
+			auto& plane = planes[k];
+
+			plane.Normal.X = nx[k];
+			plane.Normal.Y = ny[k];
+			plane.Normal.Z = nz[k];
+			plane.D = - (nx[k] * x1[k] + ny[k] * y1[k] + nz[k] * z1[k]);
+		}
+
+		if (areas != nullptr)
+		{
+			for (size_t k = 0; k < count; ++k)
+			{
+				areas[k] = 0.5 * length[k];
+			}
+		}
+	}
+
 	void QuadricErrorMetricMethod::Process(Remesh::Mesh& mesh, double targetRatio, IProgressListener* listener)
 	{
-		int totalTriangles = mesh.GetTriangles().size();
-		int trianglesLimit = (int)(targetRatio * totalTriangles);
+		size_t totalTriangles = mesh.GetTriangles().size();
+		std::vector<size_t> targets(1, (size_t)(targetRatio * totalTriangles));
 
-		Process(mesh, trianglesLimit, listener);
+		Process(mesh, targets, nullptr, listener, nullptr);
 	}
 
 	void QuadricErrorMetricMethod::Process(Remesh::Mesh& mesh, int targetTriangles, IProgressListener* listener)
 	{
-		m_Vertices = mesh.GetVertices();
-		m_Triangles = mesh.GetTriangles();
+		std::vector<size_t> targets(1, (size_t)std::max(targetTriangles, 0));
+
+		Process(mesh, targets, nullptr, listener, nullptr);
+	}
 
-		Initialize(listener);
-		Remesh(targetTriangles, listener);
+	void QuadricErrorMetricMethod::Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler)
+	{
+		QuadricErrorMetricContext context;
 
-		mesh.SetVertices(m_Vertices);
-		mesh.SetTriangles(m_Triangles);
+		Process(mesh, targetTriangles, context, snapshots, listener, scheduler);
 	}
 
-	void QuadricErrorMetricMethod::Initialize(IProgressListener* listener)
+	template <typename TScalar, typename TIndex>
+	void QuadricErrorMetricMethod::Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, BasicQuadricErrorMetricContext<TScalar, TIndex>& context, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler) const
+	{
+		context.Load(mesh);
+		context.Scheduler = scheduler;
+
+		Initialize(context, listener);
+		Remesh(context, targetTriangles, snapshots, listener);
+
+		context.Store(mesh);
+
+		// Release working state, keeping capacity for next mesh.
+		context.Clear();
+	}
+
+	template <typename TContext>
+	void QuadricErrorMetricMethod::Initialize(TContext& context, IProgressListener* listener) const
 	{
 		if (listener != nullptr)
 		{
 			listener->OnStarted("Initialize quadrics");
 		}
 
-		// Initialize error metrics for each vertex available.
-		for (auto i = 1; i <= (int)m_Vertices.size(); ++i)
-		{
-			// By empty error metric.
-			m_ErrorMetrics.insert(
-				std::make_pair(
-					(int)i,
-					ErrorMetric()
-				)
-			);
-		}
+		auto& offsets = context.VertexTriangleOffsets;
+		auto& adjacency = context.VertexTriangles;
 
-		// For each triangle compute plane metric and add it to neighbor vertex
-		for (auto it = m_Triangles.begin(); it != m_Triangles.end(); ++it)
+		// Build vertex to triangle adjacency, keeping triangle order for each vertex
+		offsets.assign(context.Vertices.size() + 1, 0);
+
+		for (auto it = context.Triangles.begin(); it != context.Triangles.end(); ++it)
 		{
 			for (auto vertex = 0; vertex < 3; ++vertex)
 			{
-				auto& vertexMetric = m_ErrorMetrics[it->Vertices[vertex]];
-				auto& planeMetric = ErrorMetric(it->Plane);
+				++offsets[it->Vertices[vertex] + 1];
+			}
+		}
+
+		for (size_t i = 1; i < offsets.size(); ++i)
+		{
+			offsets[i] += offsets[i - 1];
+		}
+
+		adjacency.resize(offsets.back());
+
+		{
+			std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
 
-				// Adding error metrics.
-				ErrorMetric::Add(vertexMetric, vertexMetric, planeMetric);
+			for (size_t i = 0; i < context.Triangles.size(); ++i)
+			{
+				for (auto vertex = 0; vertex < 3; ++vertex)
+				{
+					adjacency[next[context.Triangles[i].Vertices[vertex]]++] = i;
+				}
 			}
 		}
 
+		// Compute planes of all triangles, block by block
+		auto& planes = context.Planes;
+		auto& areas = context.Areas;
+
+		planes.resize(context.Triangles.size());
+		areas.resize(m_EnableAreaWeights ? context.Triangles.size() : 0);
+
+		size_t blocks = (context.Triangles.size() + PlaneBlockSize - 1) / PlaneBlockSize;
+
+		Threading::ParallelFor(context.Scheduler, 0, blocks, 16,
+			[&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					size_t first = i * PlaneBlockSize;
+					size_t last = std::min(first + PlaneBlockSize, context.Triangles.size());
+
+					ComputePlaneBlock(context, first, last, &planes[first], areas.empty() ? nullptr : &areas[first]);
+				}
+			});
+
+		// Initialize error metrics for each vertex available by empty error metric.
+		typedef PackedErrorMetric<typename TContext::Scalar> StoredMetric;
+
+		context.ErrorMetrics.assign(context.Vertices.size(), StoredMetric());
+
+		// For each vertex sum plane metrics of adjacent triangles. Summing in
+		// triangle order gives the same metrics as sequential accumulation.
+		Threading::ParallelFor(context.Scheduler, 0, context.Vertices.size(), 4096,
+			[&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					ErrorMetric vertexMetric;
+
+					for (auto j = offsets[i]; j < offsets[i + 1]; ++j)
+					{
+						auto triangle = adjacency[j];
+						auto planeMetric = areas.empty()
+							? ErrorMetric(planes[triangle])
+							: ErrorMetric(planes[triangle], areas[triangle]);
+
+						// Adding error metrics.
+						ErrorMetric::Add(vertexMetric, vertexMetric, planeMetric);
+					}
+
+					// Accumulated in double, stored in context precision.
+					context.ErrorMetrics[i] = StoredMetric(vertexMetric);
+				}
+			});
+
 		if (listener != nullptr)
 		{
 			listener->OnCompleted("Initialize quadrics");
 		}
 	}
 
-	void QuadricErrorMetricMethod::SelectValidPairs(double treshold, IProgressListener* listener)
+	template <typename TContext>
+	void QuadricErrorMetricMethod::SelectValidPairs(TContext& context, double treshold, IProgressListener* listener) const
 	{
 		if (listener != nullptr)
 		{
@@ -73,36 +244,40 @@ namespace QuadricErrorMetric
 		}
 
 		// For each triangle
-		for (auto it = m_Triangles.begin(); it != m_Triangles.end(); ++it)
-		{
-			// Compute edge costs (edge 01)
-			VertexPair pair;
-			pair.first = std::min(it->Vertices[0], it->Vertices[1]);
-			pair.second = std::max(it->Vertices[0], it->Vertices[1]);
-
-			if (m_Edges.find(pair) == m_Edges.end())
-			{
-				m_Edges.insert(std::make_pair(pair, ComputeError(pair)));
-			}
+		auto& edges = context.Edges;
+		auto& keys = context.EdgeKeys;
 
-			// Compute edge costs (edge 12)
-			pair.first = std::min(it->Vertices[1], it->Vertices[2]);
-			pair.second = std::max(it->Vertices[1], it->Vertices[2]);
+		keys.clear();
 
-			if (m_Edges.find(pair) == m_Edges.end())
+		for (auto it = context.Triangles.begin(); it != context.Triangles.end(); ++it)
+		{
+			// Collect edges 01, 12 and 20, costs are computed below
+			for (auto vertex = 0; vertex < 3; ++vertex)
 			{
-				m_Edges.insert(std::make_pair(pair, ComputeError(pair)));
+				auto next = (vertex + 1) % 3;
+
+				keys.push_back(EdgeErrorTable::MakeKey(
+					std::min(it->Vertices[vertex], it->Vertices[next]),
+					std::max(it->Vertices[vertex], it->Vertices[next])));
 			}
+		}
 
-			// Compute edge costs (edge 20)
-			pair.first = std::min(it->Vertices[2], it->Vertices[0]);
-			pair.second = std::max(it->Vertices[2], it->Vertices[0]);
+		edges.InsertBatch(keys.data(), keys.size(), 0.0);
 
-			if (m_Edges.find(pair) == m_Edges.end())
+		// Compute edge costs
+		Threading::ParallelFor(context.Scheduler, 0, edges.GetCapacity(), 4096,
+			[&](size_t begin, size_t end)
 			{
-				m_Edges.insert(std::make_pair(pair, ComputeError(pair)));
-			}
-		}
+				for (size_t i = begin; i < end; ++i)
+				{
+					if (edges.IsOccupied(i))
+					{
+						auto key = edges.GetKey(i);
+
+						edges.SetError(i, ComputeError(context, EdgeErrorTable::GetFirst(key), EdgeErrorTable::GetSecond(key)));
+					}
+				}
+			});
 
 		if (listener != nullptr)
 		{
@@ -119,14 +294,14 @@ namespace QuadricErrorMetric
 			}
 
 			// Search for vertex pairs with distance lesser than treshold
-			for (auto i = 1; i < (int)m_Vertices.size(); ++i)
+			for (size_t i = 0; i < context.Vertices.size(); ++i)
 			{
-				for (auto j = i + 1; j < (int)m_Vertices.size(); ++j)
+				for (size_t j = i + 1; j < context.Vertices.size(); ++j)
 				{
-					if (Math::Vec3::Distance(m_Vertices[i].Position, m_Vertices[j].Position) < treshold)
+					if (Math::Vec3::Distance(Math::Vec3(context.Vertices[i].Position), Math::Vec3(context.Vertices[j].Position)) < treshold)
 					{
 						VertexPair pair(i, j);
-						m_Edges.insert(std::make_pair(pair, ComputeError(pair)));
+						edges.Insert(EdgeErrorTable::MakeKey((unsigned int)i, (unsigned int)j), ComputeError(context, pair));
 					}
 				}
 			}
@@ -138,220 +313,345 @@ namespace QuadricErrorMetric
 		}
 	}
 
-	double QuadricErrorMetricMethod::ComputeError(Remesh::VertexId id1, Remesh::VertexId id2, Math::Vec3& error)
+	template <typename TContext>
+	double QuadricErrorMetricMethod::ComputeError(const TContext& context, size_t id1, size_t id2, Math::Vec3& error) const
 	{
 		ErrorMetric edge;
 
-		Math::Vec3 vertex;
-
 		// Get metrics for involved vertices
-		auto e1 = m_ErrorMetrics[id1];
-		auto e2 = m_ErrorMetrics[id2];
+		auto e1 = context.ErrorMetrics[id1].ToErrorMetric();
+		auto e2 = context.ErrorMetrics[id2].ToErrorMetric();
 
-		// Add and assume they represent edge error metric
+		// Add and assume they represent edge error metric, symmetric by construction
 		ErrorMetric::Add(edge, e1, e2);
 
-		// Log when they aren't symmetric
-		if (!edge.GetMatrix().IsSymetric())
+		if (m_EnableEndpointPlacement)
 		{
-			std::cerr << "The result matrix is not symmetric" << std::endl;
+			return edge.MinimizeEndpoints(context.Vertices[id1].Position, context.Vertices[id2].Position, error);
 		}
 
-		// Compute delta edge
-		ErrorMetric delta = edge;
+		// Find optimal vertex, falling back to edge points
+		return edge.Minimize(context.Vertices[id1].Position, context.Vertices[id2].Position, error);
+	}
+
+	template <typename TContext>
+	void QuadricErrorMetricMethod::EmitSnapshot(const TContext& context, size_t index, ISnapshotListener* snapshots) const
+	{
+		if (snapshots != nullptr)
 		{
-			Math::Matrix m = delta.GetMatrix();
-			{
-				m.M41 = 0.0;
-				m.M42 = 0.0;
-				m.M43 = 0.0;
-				m.M44 = 1.0;
-			}
-			delta.SetMatrix(m);
+			Remesh::Mesh snapshot;
+			context.Store(snapshot);
+
+			snapshots->OnSnapshot(index, snapshot);
 		}
+	}
 
-		double minError = 0.0;
+	template <typename TContext>
+	EdgeErrorTable::Key QuadricErrorMetricMethod::FindCheapestEdge(const TContext& context) const
+	{
+		auto& edges = context.Edges;
 
-		// If matrix is not invertible
-		if (std::abs(delta.GetMatrix().Determinant()) <= 1e-5)
+		// Minimum of error and key, so result does not depend on slot order
+		struct Candidate
 		{
-			// Take two vertices and center between them
-			Math::Vec3 v1 = m_Vertices[id1].Position;
-			Math::Vec3 v2 = m_Vertices[id2].Position;
-			Math::Vec3 v3;
-			Math::Vec3::Center(v3, v1, v2);
-			
-			// And evaluate costs
-			double e1 = edge.Evaluate(v1);
-			double e2 = edge.Evaluate(v2);
-			double e3 = edge.Evaluate(v3);
-
-			// And choose wisely
-			minError = std::min(std::min(e1, e2), e3);
+			double Error;
+			EdgeErrorTable::Key Key;
 
-			if (minError == e1)
+			void Update(double error, EdgeErrorTable::Key key)
 			{
-				vertex = v1;
+				if ((error < Error) || ((error == Error) && (Key != NoEdge) && (key < Key)))
+				{
+					Error = error;
+					Key = key;
+				}
 			}
-			else if (minError == e2)
+		};
+
+		Candidate initial = { (double)std::numeric_limits<int>::max(), NoEdge };
+		std::vector<Candidate> candidates;
+		std::mutex mutex;
+
+		Threading::ParallelFor(context.Scheduler, 0, edges.GetCapacity(), 65536,
+			[&](size_t begin, size_t end)
 			{
-				vertex = v2;
+				Candidate candidate = initial;
+
+				for (size_t i = begin; i < end; ++i)
+				{
+					// Empty slots have infinite error
+					if (edges.GetError(i) <= candidate.Error)
+					{
+						candidate.Update(edges.GetError(i), edges.GetKey(i));
+					}
+				}
+
+				std::lock_guard<std::mutex> lock(mutex);
+				candidates.push_back(candidate);
+			});
+
+		for (auto it = candidates.begin(); it != candidates.end(); ++it)
+		{
+			initial.Update(it->Error, it->Key);
+		}
+
+		return initial.Key;
+	}
+
+	template <typename TContext>
+	void QuadricErrorMetricMethod::CollapseTriangles(TContext& context, const VertexPair& pair, size_t begin, size_t end, Remesh::EdgeCollapse& collapse) const
+	{
+		auto& triangles = context.Triangles;
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (!context.TriangleAlive[i])
+			{
+				continue;
 			}
-			else if (minError == e3)
+
+			auto& triangle = triangles[i];
+
+			// And for each vertex in triangle
+			for (auto j = 0; j < 3; ++j)
 			{
-				vertex = v3;
+				if (triangle.Vertices[j] == pair.second)
+				{
+					if (triangle.HasVertex(pair.first))
+					{
+						// Erase
+						collapse.RemovedTriangles.push_back(context.TriangleIndices[i]);
+						context.TriangleAlive[i] = 0;
+					}
+					else
+					{
+						// Or not
+						collapse.ChangedTriangles.push_back(context.TriangleIndices[i]);
+						triangle.Vertices[j] = pair.first;
+					}
+					break;
+				}
 			}
 		}
-		else
-		{
-			// Otherwise compute vertex from matrix.
-			vertex = delta.GetMatrix().GetVector();
-		}
-
-		error = vertex;
-		minError = edge.Evaluate(vertex);
-		return minError;
 	}
 
-	void QuadricErrorMetricMethod::Remesh(int targetTriangles, IProgressListener* listener)
+	template <typename TContext>
+	void QuadricErrorMetricMethod::Remesh(TContext& context, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener) const
 	{
-		SelectValidPairs(0.1, listener);
+		SelectValidPairs(context, 0.1, listener);
 
 		if (listener != nullptr)
 		{
 			listener->OnStarted("Remesh");
 		}
 
+		// Visit targets in collapse order - fewest removed triangles first.
+		std::vector<size_t> order;
+
+		for (size_t i = 0; i < targetTriangles.size(); ++i)
+		{
+			order.push_back(i);
+		}
+
+		std::stable_sort(order.begin(), order.end(),
+			[&](size_t lhs, size_t rhs)
+			{
+				return targetTriangles[lhs] < targetTriangles[rhs];
+			});
+
+		auto& edges = context.Edges;
+		auto& triangles = context.Triangles;
+		auto& collapse = context.Collapse;
+
 		// Compute total and remaining triangles count.
-		int totalTriangles = m_Triangles.size();
-		int remainingTriangles = m_Triangles.size() - targetTriangles;
+		size_t totalTriangles = context.TriangleCount;
+		size_t finalTarget = order.empty() ? 0 : targetTriangles[order.back()];
 
+		size_t level = 0;
 
 		Math::Vec3 error;
 
-		// Until we don't reached remaining triangles count.
-		while ((int)m_Triangles.size() > remainingTriangles)
+		for (;;)
 		{
+			// Emit snapshots for all reached targets.
+			while ((level < order.size()) &&
+				(targetTriangles[order[level]] <= totalTriangles) &&
+				(context.TriangleCount <= totalTriangles - targetTriangles[order[level]]))
+			{
+				EmitSnapshot(context, order[level], snapshots);
+				++level;
+			}
+
+			// Until we don't reached remaining triangles count.
+			if ((level == order.size()) || edges.IsEmpty())
+			{
+				break;
+			}
+
 			if (listener != nullptr)
 			{
-				listener->OnStep(
-					targetTriangles - (m_Triangles.size() - remainingTriangles),
-					targetTriangles);
+				ReportStep(listener, totalTriangles - context.TriangleCount, finalTarget);
 			}
 			
-			double minError = (double)std::numeric_limits<int>::max();
-
-			EdgeErrorContainer::iterator itMinError;
+			// Find cheapest edge, ties resolved by lowest pair
+			EdgeErrorTable::Key minKey = FindCheapestEdge(context);
 
-			// Find cheapest edge
-			for (auto it = m_Edges.begin(); it != m_Edges.end(); ++it)
+			if (minKey == NoEdge)
 			{
-				if (it->second < minError)
-				{
-					minError = it->second;
-					itMinError = it;
-				}
+				break;
 			}
 
 			// Compute error for pair
-			VertexPair pairMinError = itMinError->first;
+			VertexPair pairMinError(EdgeErrorTable::GetFirst(minKey), EdgeErrorTable::GetSecond(minKey));
+
+			ComputeError(context, pairMinError, error);
 
-			ComputeError(pairMinError, error);
+			// Vertex at chosen endpoint is kept
+			if (m_EnableEndpointPlacement && (error != Math::Vec3(context.Vertices[pairMinError.first].Position)))
+			{
+				std::swap(pairMinError.first, pairMinError.second);
+			}
 
-			m_Vertices[pairMinError.first].Position = error;
+			context.Vertices[pairMinError.first].Position = error;
 			
 			// Compute error metric
-			ErrorMetric::Add(
-				m_ErrorMetrics[pairMinError.first],
-				m_ErrorMetrics[pairMinError.first],
-				m_ErrorMetrics[pairMinError.second]);
+			PackedErrorMetric<typename TContext::Scalar>::Add(
+				context.ErrorMetrics[pairMinError.first],
+				context.ErrorMetrics[pairMinError.first],
+				context.ErrorMetrics[pairMinError.second]);
+
+			collapse.Kept = context.VertexIds[pairMinError.first];
+			collapse.Removed = context.VertexIds[pairMinError.second];
+			// Position is recorded as stored, so replay matches single precision output
+			collapse.Position = Math::Vec3(context.Vertices[pairMinError.first].Position);
+			collapse.RemovedTriangles.clear();
+			collapse.ChangedTriangles.clear();
 
 			// And for each triangle
-			for (auto it = m_Triangles.begin(); it != m_Triangles.end();)
+			if (context.Scheduler == nullptr)
+			{
+				CollapseTriangles(context, pairMinError, 0, triangles.size(), collapse);
+			}
+			else
 			{
-				// And for each vertex in triangle
-				for (auto j = 0; j < 3; ++j)
+				// Scan fixed ranges, merged in order to keep triangle order
+				auto& chunks = context.CollapseChunks;
+				size_t chunkSize = 65536;
+				size_t chunkCount = (triangles.size() + chunkSize - 1) / chunkSize;
+
+				if (chunks.size() < chunkCount)
 				{
-					if (it->Vertices[j] == pairMinError.second)
+					chunks.resize(chunkCount);
+				}
+
+				Threading::ParallelFor(context.Scheduler, 0, chunkCount, 1,
+					[&](size_t begin, size_t end)
 					{
-						if (
-							(it->Vertices[0] == pairMinError.first) ||
-							(it->Vertices[1] == pairMinError.first) ||
-							(it->Vertices[2] == pairMinError.first))
-						{
-							// Erase
-							it = m_Triangles.erase(it);
-						}
-						else
+						for (size_t i = begin; i < end; ++i)
 						{
-							// Or not
-							it->Vertices[j] = pairMinError.first;
-							++it;
+							chunks[i].RemovedTriangles.clear();
+							chunks[i].ChangedTriangles.clear();
+
+							CollapseTriangles(context, pairMinError,
+								i * chunkSize,
+								std::min((i + 1) * chunkSize, triangles.size()),
+								chunks[i]);
 						}
-						break;
-					}
-					else if (j == 2)
-					{
-						++it;
-					}
+					});
+
+				for (size_t i = 0; i < chunkCount; ++i)
+				{
+					collapse.RemovedTriangles.insert(collapse.RemovedTriangles.end(), chunks[i].RemovedTriangles.begin(), chunks[i].RemovedTriangles.end());
+					collapse.ChangedTriangles.insert(collapse.ChangedTriangles.end(), chunks[i].ChangedTriangles.begin(), chunks[i].ChangedTriangles.end());
 				}
 			}
 
+			context.TriangleCount -= collapse.RemovedTriangles.size();
+
+			if (context.GetCollapseListener() != nullptr)
+			{
+				context.GetCollapseListener()->OnCollapse(collapse);
+			}
+
 			// And erase second vertex - it's merged now with first
-			m_Vertices.erase(pairMinError.second);
+			context.VertexAlive[pairMinError.second] = 0;
+
+			// Find edges of both collapsed vertices
+			auto& moved = context.MovedVertices;
+			auto& involved = context.EdgeKeys;
+
+			moved.clear();
+			involved.clear();
 
-			// Update involved edges costs - set as 0
-			for (auto it = m_Edges.begin(); it != m_Edges.end(); /*++it*/)
+			for (size_t i = 0; i < edges.GetCapacity(); ++i)
 			{
-				auto pair = it->first;
+				if (!edges.IsOccupied(i))
+				{
+					continue;
+				}
+
+				auto key = edges.GetKey(i);
+				auto first = EdgeErrorTable::GetFirst(key);
+				auto second = EdgeErrorTable::GetSecond(key);
 
-				if ((pair.first == pairMinError.second) && (pair.second != pairMinError.first))
+				if ((first == pairMinError.second) && (second != pairMinError.first))
 				{
-					it = m_Edges.erase(it);
-
-					m_Edges.insert(std::make_pair(
-						VertexPair(
-							std::min(pairMinError.first, pair.second),
-							std::max(pairMinError.first, pair.second)
-						),
-						0.0
-					));
+					moved.push_back(second);
 				}
-				else if ((pair.second == pairMinError.second) && (pair.first != pairMinError.first))
+				else if ((second == pairMinError.second) && (first != pairMinError.first))
 				{
-					it = m_Edges.erase(it);
-
-					m_Edges.insert(std::make_pair(
-						VertexPair(
-							std::min(pairMinError.first, pair.first),
-							std::max(pairMinError.first, pair.first)
-						),
-						0.0
-					));
+					moved.push_back(first);
 				}
-				else
+				else if ((key != minKey) && ((first == pairMinError.first) || (second == pairMinError.first)))
 				{
-					++it;
+					involved.push_back(key);
 				}
 			}
 
-			m_Edges.erase(itMinError);
+			// Move edges of removed vertex to kept one - set as 0
+			auto kept = (unsigned int)pairMinError.first;
+			auto removed = (unsigned int)pairMinError.second;
 
-			// Recompute all involved edges costs.
-			for (auto it = m_Edges.begin(); it != m_Edges.end(); ++it)
+			for (auto it = moved.begin(); it != moved.end(); ++it)
 			{
-				auto pair = it->first;
+				unsigned int other = *it;
 
-				if (pair.first == pairMinError.first)
-				{
-					it->second = ComputeError(pairMinError.first, pair.second);
-				}
+				edges.Erase(removed < other
+					? EdgeErrorTable::MakeKey(removed, other)
+					: EdgeErrorTable::MakeKey(other, removed));
 
-				if (pair.second == pairMinError.first)
+				auto key = EdgeErrorTable::MakeKey(
+					std::min(kept, other),
+					std::max(kept, other));
+
+				if (edges.Insert(key, 0.0))
 				{
-					it->second = ComputeError(pairMinError.first, pair.first);
+					involved.push_back(key);
 				}
 			}
+
+			edges.Erase(minKey);
+
+			// Recompute all involved edges costs.
+			for (auto it = involved.begin(); it != involved.end(); ++it)
+			{
+				auto first = EdgeErrorTable::GetFirst(*it);
+				auto other = (first == pairMinError.first) ? EdgeErrorTable::GetSecond(*it) : first;
+
+				edges.SetError(edges.Find(*it), ComputeError(context, pairMinError.first, other));
+			}
+
+			// Keep working set dense as mesh shrinks
+			if ((triangles.size() >= MinCompactedTriangles) &&
+				(context.TriangleCount < m_CompactionThreshold * triangles.size()))
+			{
+				context.Compact();
+			}
+		}
+
+		// Mesh ran out of edges before reaching remaining targets.
+		for (; level < order.size(); ++level)
+		{
+			EmitSnapshot(context, order[level], snapshots);
 		}
 
 		if (listener != nullptr)
@@ -359,5 +659,10 @@ namespace QuadricErrorMetric
 			listener->OnCompleted("Remesh");
 		}
 	}
+
+	template void QuadricErrorMetricMethod::Process(Remesh::Mesh&, const std::vector<size_t>&, BasicQuadricErrorMetricContext<float, unsigned short>&, ISnapshotListener*, IProgressListener*, Threading::TaskScheduler*) const;
+	template void QuadricErrorMetricMethod::Process(Remesh::Mesh&, const std::vector<size_t>&, BasicQuadricErrorMetricContext<float, unsigned int>&, ISnapshotListener*, IProgressListener*, Threading::TaskScheduler*) const;
+	template void QuadricErrorMetricMethod::Process(Remesh::Mesh&, const std::vector<size_t>&, BasicQuadricErrorMetricContext<double, unsigned short>&, ISnapshotListener*, IProgressListener*, Threading::TaskScheduler*) const;
+	template void QuadricErrorMetricMethod::Process(Remesh::Mesh&, const std::vector<size_t>&, BasicQuadricErrorMetricContext<double, unsigned int>&, ISnapshotListener*, IProgressListener*, Threading::TaskScheduler*) const;
 }
 }
\ No newline at end of file
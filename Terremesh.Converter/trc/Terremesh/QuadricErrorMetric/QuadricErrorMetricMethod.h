@@ -6,14 +6,21 @@
 
 #include "../IProgressListener.h"
 #include "../IRemeshingMethod.h"
+#include "../ISnapshotListener.h"
 #include "../Remesh/Mesh.h"
 #include "ErrorMetric.h"
+#include "QuadricErrorMetricContext.h"
 
 namespace Terremesh
 {
 namespace QuadricErrorMetric
 {
 	/// Implementation of Quadric Error Metric method.
+	///
+	/// @remarks
+	///		Method keeps no per-job state, all of it lives in context. Single
+	///		instance may be used by many threads at once, as long as each
+	///		of them uses its own context.
 	class QuadricErrorMetricMethod
 		: public IRemeshingMethod
 		{
@@ -22,10 +29,34 @@ namespace QuadricErrorMetric
 		QuadricErrorMetricMethod()
 		{
 			m_EnableVirtualPairs = false;
+			m_CompactionThreshold = 0.5;
+			m_EnableAreaWeights = false;
+			m_EnableEndpointPlacement = false;
 		}
 		
 		virtual void Process(Remesh::Mesh& mesh, double targetRatio, IProgressListener* listener);
 		virtual void Process(Remesh::Mesh& mesh, int targetTriangles, IProgressListener* listener);
+		virtual void Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler);
+
+		/// Processes mesh using multiple triangles counts in single pass.
+		///
+		/// @param[in,out] mesh
+		///		The mesh to process. Receives mesh for largest target.
+		/// @param[in] targetTriangles
+		///		The numbers of target triangles.
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] snapshots
+		///		The listener receiving mesh for each target.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler running parallel parts of method, or nullptr.
+		///
+		/// @remarks
+		///		Instantiated for float and double scalars with 16-bit and 32-bit indices.
+		template <typename TScalar, typename TIndex>
+		void Process(Remesh::Mesh& mesh, const std::vector<size_t>& targetTriangles, BasicQuadricErrorMetricContext<TScalar, TIndex>& context, ISnapshotListener* snapshots, IProgressListener* listener, Threading::TaskScheduler* scheduler) const;
 
 		/// Gets value indicating whether method is using virtual pairs.
 		///
@@ -39,56 +70,142 @@ namespace QuadricErrorMetric
 		///		The value.
 		void SetEnableVirtualPairs(bool value) { m_EnableVirtualPairs = value; }
 
-	private:
-		/// The ertex pair type.
-		typedef std::pair<Remesh::VertexId, Remesh::VertexId> VertexPair;
+		/// Gets value indicating whether plane quadrics are weighted by triangle area.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool GetEnableAreaWeights() const { return m_EnableAreaWeights; }
 
-		/// The error metric container type.
-		typedef std::map<Remesh::VertexId, ErrorMetric> ErrorMetricContainer;
+		/// Sets value indicating whether plane quadrics are weighted by triangle area.
+		///
+		/// @param[in] value
+		///		The value.
+		void SetEnableAreaWeights(bool value) { m_EnableAreaWeights = value; }
 
-		/// The edge error container type.
-		typedef std::map<VertexPair, double> EdgeErrorContainer;
+		/// Gets value indicating whether merged vertex is placed at one of edge endpoints.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool GetEnableEndpointPlacement() const { return m_EnableEndpointPlacement; }
 
-		/// Triangle container.
-		Remesh::Mesh::TriangleContainer m_Triangles;
+		/// Sets value indicating whether merged vertex is placed at one of edge endpoints.
+		///
+		/// @param[in] value
+		///		The value.
+		///
+		/// @remarks
+		///		Collapse keeps vertex at chosen endpoint, so every vertex of
+		///		output mesh keeps its input position.
+		void SetEnableEndpointPlacement(bool value) { m_EnableEndpointPlacement = value; }
 
-		/// Vertex container.
-		Remesh::Mesh::VertexContainer m_Vertices;
+		/// Gets fraction of present triangles below which context is compacted.
+		///
+		/// @return
+		///		The fraction, zero when compaction is disabled.
+		double GetCompactionThreshold() const { return m_CompactionThreshold; }
+
+		/// Sets fraction of present triangles below which context is compacted.
+		///
+		/// @param[in] value
+		///		The fraction, zero disables compaction.
+		void SetCompactionThreshold(double value) { m_CompactionThreshold = value; }
 
-		/// Error metrics container.
-		ErrorMetricContainer m_ErrorMetrics;
+	private:
+		/// The vertex pair type.
+		typedef QuadricErrorMetricContext::VertexPair VertexPair;
+
+		/// The edge error container type.
+		typedef QuadricErrorMetricContext::EdgeErrorContainer EdgeErrorContainer;
 
-		/// Edge error container.
-		EdgeErrorContainer m_Edges;
+		/// The key returned when no edge is left.
+		static const EdgeErrorTable::Key NoEdge = ~0ULL;
 
 		/// Virtual pairs.
 		bool m_EnableVirtualPairs;
+
+		/// Compaction threshold.
+		double m_CompactionThreshold;
+
+		/// Area weighted plane quadrics.
+		bool m_EnableAreaWeights;
+
+		/// Endpoint placement of merged vertex.
+		bool m_EnableEndpointPlacement;
 		
 	private:
 		/// Initializes mesh for remeshing.
 		///
+		/// @param[in,out] context
+		///		The job context.
 		/// @param[in] listener
 		///		The progress listener.
-		void Initialize(IProgressListener* listener);
+		template <typename TContext>
+		void Initialize(TContext& context, IProgressListener* listener) const;
 
 		/// Selects valid pairs.
 		///
+		/// @param[in,out] context
+		///		The job context.
 		/// @param[in] treshold
 		///		The treshold for virtual pairs.
 		/// @param[in] listener
 		///		The progress listener.
-		void SelectValidPairs(double treshold = 0.10, IProgressListener* listener = nullptr);
+		template <typename TContext>
+		void SelectValidPairs(TContext& context, double treshold = 0.10, IProgressListener* listener = nullptr) const;
 
 		/// Remeshes mesh.
 		///
+		/// @param[in,out] context
+		///		The job context.
 		/// @param[in] targetTriangles
-		///		The number of target mesh triangles.
+		///		The numbers of target mesh triangles.
+		/// @param[in] snapshots
+		///		The listener receiving mesh for each target.
 		/// @param[in] listener
 		///		The progress listener.
-		void Remesh(int targetTriangles, IProgressListener* listener);
+		template <typename TContext>
+		void Remesh(TContext& context, const std::vector<size_t>& targetTriangles, ISnapshotListener* snapshots, IProgressListener* listener) const;
+
+		/// Emits snapshot of current mesh.
+		///
+		/// @param[in] context
+		///		The job context.
+		/// @param[in] index
+		///		The index of reached target.
+		/// @param[in] snapshots
+		///		The snapshot listener.
+		template <typename TContext>
+		void EmitSnapshot(const TContext& context, size_t index, ISnapshotListener* snapshots) const;
+
+		/// Finds edge with lowest error.
+		///
+		/// @param[in] context
+		///		The job context.
+		///
+		/// @return
+		///		The key of edge with lowest error and lowest pair, or NoEdge.
+		template <typename TContext>
+		EdgeErrorTable::Key FindCheapestEdge(const TContext& context) const;
+
+		/// Replaces removed vertex of collapse in range of triangles.
+		///
+		/// @param[in,out] context
+		///		The job context.
+		/// @param[in] pair
+		///		The collapsed vertex pair.
+		/// @param[in] begin
+		///		The first triangle index.
+		/// @param[in] end
+		///		The past-the-end triangle index.
+		/// @param[out] collapse
+		///		The collapse receiving removed and changed triangles.
+		template <typename TContext>
+		void CollapseTriangles(TContext& context, const VertexPair& pair, size_t begin, size_t end, Remesh::EdgeCollapse& collapse) const;
 
 		/// Computes error for vertices pair.
 		///
+		/// @param[in] context
+		///		The job context.
 		/// @param[in] pair
 		///		The vertex pair.
 		/// @param[out] error
@@ -96,50 +213,60 @@ namespace QuadricErrorMetric
 		///
 		/// @return
 		///		The error value.
-		double ComputeError(const VertexPair& pair, Math::Vec3& error)
+		template <typename TContext>
+		double ComputeError(const TContext& context, const VertexPair& pair, Math::Vec3& error) const
 		{
-			return ComputeError(pair.first, pair.second, error);
+			return ComputeError(context, pair.first, pair.second, error);
 		}
 
 		/// Computes error for vertices pair.
 		///
+		/// @param[in] context
+		///		The job context.
 		/// @param[in] pair
 		///		The vertex pair.
 		///
 		/// @return
 		///		The error value.
-		double ComputeError(const VertexPair& pair)
+		template <typename TContext>
+		double ComputeError(const TContext& context, const VertexPair& pair) const
 		{
 			Math::Vec3 error;
-			return ComputeError(pair, error);
+			return ComputeError(context, pair, error);
 		}
 
 		/// Computes error for vertices pair.
 		///
+		/// @param[in] context
+		///		The job context.
 		/// @param[in] id1
-		///		The vertex ID.
+		///		The vertex index.
 		/// @param[in] id2
-		///		The vertex ID.
+		///		The vertex index.
 		/// @param[out] error
 		///		The error point.
 		///
 		/// @returns
 		///		The error value.
-		double ComputeError(Remesh::VertexId id1, Remesh::VertexId id2, Math::Vec3& error);
+		template <typename TContext>
+		double ComputeError(const TContext& context, size_t id1, size_t id2, Math::Vec3& error) const;
 
 		/// Computes error for vertices pair.
 		///
+		/// @param[in] context
+		///		The job context.
 		/// @param[in] id1
-		///		The vertex ID.
+		///		The vertex index.
 		/// @param[in] id2
-		///		The vertex ID.
+		///		The vertex index.
 		///
 		/// @returns
 		///		The error value.
-		double ComputeError(Remesh::VertexId id1, Remesh::VertexId id2)
+		template <typename TContext>
+		double ComputeError(const TContext& context, size_t id1, size_t id2) const
 		{
 			Math::Vec3 error;
-			return ComputeError(id1, id2, error);
+			return ComputeError(context, id1, id2, error);
 		}
 	};
 }
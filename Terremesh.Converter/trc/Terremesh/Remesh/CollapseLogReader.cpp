@@ -0,0 +1,101 @@
+#include "CollapseLogReader.h"
+#include "CollapseReplayer.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	CollapseLogReader::CollapseLogReader(std::ifstream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	bool CollapseLogReader::Read(Mesh& mesh, IProgressListener* listener)
+	{
+		char magic[4];
+		unsigned int vertexCount = 0;
+		unsigned int triangleCount = 0;
+
+		if (!m_Stream.read(magic, 4) || (std::string(magic, 4) != "TCL1") ||
+			!ReadValue(vertexCount) || !ReadValue(triangleCount))
+		{
+			std::cerr << "Invalid collapse log" << std::endl;
+			return false;
+		}
+
+		if ((vertexCount != mesh.GetVertices().size()) || (triangleCount != mesh.GetTriangles().size()))
+		{
+			std::cerr << "Collapse log was recorded for different mesh" << std::endl;
+			return false;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Replay");
+		}
+
+		CollapseReplayer replayer(mesh);
+		EdgeCollapse collapse;
+
+		unsigned int kept;
+		unsigned int removed;
+		unsigned int removedCount;
+		unsigned int changedCount;
+		unsigned int id;
+
+		while (ReadValue(kept))
+		{
+			if (!ReadValue(removed) ||
+				!ReadValue(collapse.Position.X) ||
+				!ReadValue(collapse.Position.Y) ||
+				!ReadValue(collapse.Position.Z) ||
+				!ReadValue(removedCount) ||
+				!ReadValue(changedCount))
+			{
+				std::cerr << "Truncated collapse log" << std::endl;
+				return false;
+			}
+
+			collapse.Kept = (VertexId)kept;
+			collapse.Removed = (VertexId)removed;
+			collapse.RemovedTriangles.clear();
+			collapse.ChangedTriangles.clear();
+
+			if ((replayer.GetVertices().count(collapse.Kept) == 0) || (replayer.GetVertices().count(collapse.Removed) == 0))
+			{
+				std::cerr << "Collapse log was recorded for different mesh" << std::endl;
+				return false;
+			}
+
+			for (unsigned int i = 0; i < removedCount + changedCount; ++i)
+			{
+				if (!ReadValue(id) || (id >= triangleCount))
+				{
+					std::cerr << "Truncated collapse log" << std::endl;
+					return false;
+				}
+
+				if (i < removedCount)
+				{
+					collapse.RemovedTriangles.push_back(id);
+				}
+				else
+				{
+					collapse.ChangedTriangles.push_back(id);
+				}
+			}
+
+			replayer.Apply(collapse);
+		}
+
+		replayer.GetMesh(mesh);
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Replay");
+		}
+
+		return true;
+	}
+}
+}
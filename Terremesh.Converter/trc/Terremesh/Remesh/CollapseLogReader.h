@@ -0,0 +1,53 @@
+#pragma once
+#ifndef _Terremesh_Remesh_CollapseLogReader_H__
+#define _Terremesh_Remesh_CollapseLogReader_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements collapse log reader.
+	///
+	/// @remarks
+	///		See CollapseLogWriter for log format.
+	class CollapseLogReader
+	{
+	public:
+		/// Creates instance of the CollapseLogReader class.
+		///
+		/// @param[in] stream
+		///		The binary input stream.
+		CollapseLogReader(std::ifstream& stream);
+
+		/// Reads collapses from stream and applies them to mesh.
+		///
+		/// @param[in,out] mesh
+		///		The mesh, which must be the input mesh of the log.
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Read(Mesh& mesh, IProgressListener* listener);
+
+	private:
+		CollapseLogReader(const CollapseLogReader&);
+		CollapseLogReader& operator = (const CollapseLogReader&);
+
+		/// Reads raw value from stream.
+		template <typename T>
+		bool ReadValue(T& value)
+		{
+			return !m_Stream.read(reinterpret_cast<char*>(&value), sizeof(value)).fail();
+		}
+
+		std::ifstream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_CollapseLogReader_H__ */
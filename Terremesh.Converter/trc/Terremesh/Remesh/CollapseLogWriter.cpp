@@ -0,0 +1,46 @@
+#include "CollapseLogWriter.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	CollapseLogWriter::CollapseLogWriter(std::ofstream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	void CollapseLogWriter::WriteHeader(const Mesh& mesh)
+	{
+		m_Stream.write("TCL1", 4);
+		WriteValue((unsigned int)mesh.GetVertices().size());
+		WriteValue((unsigned int)mesh.GetTriangles().size());
+	}
+
+	void CollapseLogWriter::OnCollapse(const EdgeCollapse& collapse)
+	{
+		WriteValue((unsigned int)collapse.Kept);
+		WriteValue((unsigned int)collapse.Removed);
+		WriteValue(collapse.Position.X);
+		WriteValue(collapse.Position.Y);
+		WriteValue(collapse.Position.Z);
+		WriteValue((unsigned int)collapse.RemovedTriangles.size());
+		WriteValue((unsigned int)collapse.ChangedTriangles.size());
+
+		for (auto id = collapse.RemovedTriangles.begin(); id != collapse.RemovedTriangles.end(); ++id)
+		{
+			WriteValue((unsigned int)*id);
+		}
+
+		for (auto id = collapse.ChangedTriangles.begin(); id != collapse.ChangedTriangles.end(); ++id)
+		{
+			WriteValue((unsigned int)*id);
+		}
+	}
+
+	bool CollapseLogWriter::Finish()
+	{
+		m_Stream.flush();
+		return m_Stream.good();
+	}
+}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#ifndef _Terremesh_Remesh_CollapseLogWriter_H__
+#define _Terremesh_Remesh_CollapseLogWriter_H__
+
+#include "../Required.h"
+#include "../ICollapseListener.h"
+#include "Mesh.h"
+#include "EdgeCollapse.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements collapse log writer.
+	///
+	/// @remarks
+	///		Collapses are written as they are performed. All values are
+	///		little endian:
+	///
+	///			char[4]   "TCL1"
+	///			uint32    input vertex count
+	///			uint32    input triangle count
+	///			collapses, until end of stream:
+	///				uint32    kept vertex ID
+	///				uint32    removed vertex ID
+	///				double[3] kept vertex position
+	///				uint32    removed triangle count
+	///				uint32    changed triangle count
+	///				uint32    removed triangle indices
+	///				uint32    changed triangle indices
+	class CollapseLogWriter
+		: public ICollapseListener
+	{
+	public:
+		/// Creates instance of the CollapseLogWriter class.
+		///
+		/// @param[in] stream
+		///		The binary output stream.
+		CollapseLogWriter(std::ofstream& stream);
+
+		/// Writes log header.
+		///
+		/// @param[in] mesh
+		///		The input mesh.
+		void WriteHeader(const Mesh& mesh);
+
+		virtual void OnCollapse(const EdgeCollapse& collapse);
+
+		/// Flushes log after last collapse.
+		///
+		/// @retval true when whole log was written.
+		/// @retval false otherwise.
+		bool Finish();
+
+	private:
+		CollapseLogWriter(const CollapseLogWriter&);
+		CollapseLogWriter& operator = (const CollapseLogWriter&);
+
+		/// Writes raw value into stream.
+		template <typename T>
+		void WriteValue(const T& value)
+		{
+			m_Stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		std::ofstream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_CollapseLogWriter_H__ */
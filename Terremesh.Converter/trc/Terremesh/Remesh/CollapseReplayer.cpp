@@ -0,0 +1,53 @@
+#include "CollapseReplayer.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	CollapseReplayer::CollapseReplayer(const Mesh& mesh)
+		: m_Vertices(mesh.GetVertices())
+		, m_Triangles(mesh.GetTriangles().begin(), mesh.GetTriangles().end())
+		, m_Alive(mesh.GetTriangles().size(), true)
+	{
+	}
+
+	void CollapseReplayer::Apply(const EdgeCollapse& collapse)
+	{
+		m_Vertices[collapse.Kept].Position = collapse.Position;
+		m_Vertices.erase(collapse.Removed);
+
+		for (auto id = collapse.RemovedTriangles.begin(); id != collapse.RemovedTriangles.end(); ++id)
+		{
+			m_Alive[*id] = false;
+		}
+
+		for (auto id = collapse.ChangedTriangles.begin(); id != collapse.ChangedTriangles.end(); ++id)
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				if (m_Triangles[*id].Vertices[j] == collapse.Removed)
+				{
+					m_Triangles[*id].Vertices[j] = collapse.Kept;
+					break;
+				}
+			}
+		}
+	}
+
+	void CollapseReplayer::GetMesh(Mesh& mesh) const
+	{
+		Mesh::TriangleContainer triangles;
+
+		for (size_t i = 0; i < m_Triangles.size(); ++i)
+		{
+			if (m_Alive[i])
+			{
+				triangles.push_back(m_Triangles[i]);
+			}
+		}
+
+		mesh.SetVertices(m_Vertices);
+		mesh.SetTriangles(triangles);
+	}
+}
+}
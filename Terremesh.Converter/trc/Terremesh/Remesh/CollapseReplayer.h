@@ -0,0 +1,76 @@
+#pragma once
+#ifndef _Terremesh_Remesh_CollapseReplayer_H__
+#define _Terremesh_Remesh_CollapseReplayer_H__
+
+#include "../Required.h"
+#include "Mesh.h"
+#include "EdgeCollapse.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements applying recorded collapses to mesh.
+	///
+	/// @remarks
+	///		Removed triangles are kept with vertices they had when removed,
+	///		so triangles stay addressable by their input mesh index.
+	class CollapseReplayer
+	{
+	public:
+		/// Creates instance of the CollapseReplayer class.
+		///
+		/// @param[in] mesh
+		///		The input mesh.
+		CollapseReplayer(const Mesh& mesh);
+
+		/// Applies collapse.
+		///
+		/// @param[in] collapse
+		///		The collapse.
+		void Apply(const EdgeCollapse& collapse);
+
+		/// Gets current vertices.
+		///
+		/// @return
+		///		The vertex container.
+		const Mesh::VertexContainer& GetVertices() const { return m_Vertices; }
+
+		/// Gets all triangles, indexed by input mesh index.
+		///
+		/// @return
+		///		The triangles.
+		const std::vector<Triangle>& GetTriangles() const { return m_Triangles; }
+
+		/// Determines whether triangle is still present in mesh.
+		///
+		/// @param[in] id
+		///		The input mesh index of triangle.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool IsAlive(size_t id) const { return m_Alive[id]; }
+
+		/// Stores current mesh.
+		///
+		/// @param[out] mesh
+		///		The mesh.
+		void GetMesh(Mesh& mesh) const;
+
+	private:
+		CollapseReplayer(const CollapseReplayer&);
+		CollapseReplayer& operator = (const CollapseReplayer&);
+
+		/// Vertices container.
+		Mesh::VertexContainer m_Vertices;
+
+		/// Triangles container.
+		std::vector<Triangle> m_Triangles;
+
+		/// Triangle presence flags.
+		std::vector<bool> m_Alive;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_CollapseReplayer_H__ */
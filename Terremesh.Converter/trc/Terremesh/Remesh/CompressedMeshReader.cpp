@@ -0,0 +1,344 @@
+#include "CompressedMeshReader.h"
+#include "CompressedMeshState.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Reads bounded input.
+	class CompressedInput
+	{
+	public:
+		CompressedInput(const unsigned char* data, size_t size)
+			: m_Data(data)
+			, m_End(data + size)
+			, m_Valid(true)
+		{
+		}
+
+		/// Checks whether all reads were within input.
+		bool IsValid() const { return m_Valid; }
+
+		/// Checks whether whole input was read.
+		bool IsAtEnd() const { return m_Data == m_End; }
+
+		/// Reads raw value.
+		template <typename T>
+		T ReadValue()
+		{
+			T value = T();
+
+			if ((size_t)(m_End - m_Data) < sizeof(T))
+			{
+				m_Valid = false;
+				return value;
+			}
+
+			memcpy(&value, m_Data, sizeof(T));
+			m_Data += sizeof(T);
+			return value;
+		}
+
+		/// Reads variable length unsigned value.
+		unsigned int ReadVarint()
+		{
+			unsigned int value = 0;
+
+			for (auto shift = 0; shift < 35; shift += 7)
+			{
+				if (m_Data == m_End)
+				{
+					break;
+				}
+
+				unsigned char byte = *m_Data++;
+				value |= (unsigned int)(byte & 0x7F) << shift;
+
+				if ((byte & 0x80) == 0)
+				{
+					return value;
+				}
+			}
+
+			m_Valid = false;
+			return 0;
+		}
+
+		/// Splits input, returning first size bytes.
+		CompressedInput Take(size_t size)
+		{
+			if ((size_t)(m_End - m_Data) < size)
+			{
+				m_Valid = false;
+				size = 0;
+			}
+
+			CompressedInput result(m_Data, size);
+			m_Data += size;
+			return result;
+		}
+
+	private:
+		const unsigned char* m_Data;
+		const unsigned char* m_End;
+		bool m_Valid;
+	};
+
+	CompressedMeshReader::CompressedMeshReader(std::istream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	bool CompressedMeshReader::Read(Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Read compressed");
+		}
+
+		std::vector<unsigned char> data(
+			(std::istreambuf_iterator<char>(m_Stream)),
+			std::istreambuf_iterator<char>());
+
+		bool result = Decode(data.data(), data.size(), mesh);
+
+		if (!result)
+		{
+			std::cerr << "Invalid compressed mesh" << std::endl;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Read compressed");
+		}
+
+		return result;
+	}
+
+	bool CompressedMeshReader::Decode(const unsigned char* data, size_t size, Mesh& mesh)
+	{
+		mesh.Clear();
+
+		CompressedInput input(data, size);
+
+		auto magic = input.ReadValue<unsigned int>();
+		auto vertexCount = input.ReadValue<unsigned int>();
+		auto triangleCount = input.ReadValue<unsigned int>();
+		auto positionBits = input.ReadValue<unsigned int>();
+
+		float boundsMin[3];
+		float boundsExtent[3];
+
+		for (auto j = 0; j < 3; ++j)
+		{
+			boundsMin[j] = input.ReadValue<float>();
+		}
+
+		for (auto j = 0; j < 3; ++j)
+		{
+			boundsExtent[j] = input.ReadValue<float>();
+		}
+
+		auto connectivitySize = input.ReadValue<unsigned int>();
+		auto coordinatesSize = input.ReadValue<unsigned int>();
+
+		if (!input.IsValid() || (memcmp(&magic, "TMC1", 4) != 0) || (positionBits < 1) || (positionBits > 24))
+		{
+			return false;
+		}
+
+		auto connectivity = input.Take(connectivitySize);
+		auto coordinates = input.Take(coordinatesSize);
+
+		// Each triangle takes at least one byte, each vertex three
+		if (!input.IsValid() || !input.IsAtEnd() || (triangleCount > connectivitySize) || (vertexCount > coordinatesSize / 3))
+		{
+			return false;
+		}
+
+		std::vector<int> ordered;
+		std::vector<unsigned int> indices;
+		unsigned int next = 0;
+		int last[3] = { 0, 0, 0 };
+
+		ordered.reserve((size_t)vertexCount * 3);
+		indices.reserve((size_t)triangleCount * 3);
+
+		auto decodeVertex = [&](const int* prediction) -> bool
+		{
+			if (next >= vertexCount)
+			{
+				return false;
+			}
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				int value = prediction[j] + CompressedMeshState::DecodeZigZag(coordinates.ReadVarint());
+
+				ordered.push_back(value);
+				last[j] = value;
+			}
+
+			++next;
+			return coordinates.IsValid();
+		};
+
+		CompressedMeshState state;
+
+		for (unsigned int i = 0; i < triangleCount; ++i)
+		{
+			auto code = connectivity.ReadValue<unsigned char>();
+			unsigned int distance = code >> 4;
+
+			if (distance < 15)
+			{
+				if (distance >= std::min(state.GetEdgeCount(), CompressedMeshState::FifoSize - 1))
+				{
+					return false;
+				}
+
+				auto edge = state.GetEdge(distance);
+				unsigned int third = code & 0x0F;
+				unsigned int c;
+
+				if (third == 0)
+				{
+					// Parallelogram rule across shared edge
+					int prediction[3];
+
+					for (auto j = 0; j < 3; ++j)
+					{
+						prediction[j] = ordered[edge.A * 3 + j] + ordered[edge.B * 3 + j] - ordered[edge.Opposite * 3 + j];
+					}
+
+					c = next;
+
+					if (!decodeVertex(prediction))
+					{
+						return false;
+					}
+
+					state.PushVertex(c);
+				}
+				else if (third < 15)
+				{
+					if (third - 1 >= std::min(state.GetVertexCount(), CompressedMeshState::FifoSize - 2))
+					{
+						return false;
+					}
+
+					c = state.GetVertex(third - 1);
+				}
+				else
+				{
+					auto offset = connectivity.ReadVarint();
+
+					if ((offset == 0) || (offset > next))
+					{
+						return false;
+					}
+
+					c = next - offset;
+					state.PushVertex(c);
+				}
+
+				indices.push_back(edge.A);
+				indices.push_back(edge.B);
+				indices.push_back(c);
+				state.PushTriangle(edge.A, edge.B, c, true);
+			}
+			else if (code == 0xF0)
+			{
+				unsigned int triangle[3];
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					auto offset = connectivity.ReadVarint();
+
+					if (offset == 0)
+					{
+						triangle[j] = next;
+
+						if (!decodeVertex(last))
+						{
+							return false;
+						}
+					}
+					else if (offset <= next)
+					{
+						triangle[j] = next - offset;
+					}
+					else
+					{
+						return false;
+					}
+
+					state.PushVertex(triangle[j]);
+					indices.push_back(triangle[j]);
+				}
+
+				state.PushTriangle(triangle[0], triangle[1], triangle[2], false);
+			}
+			else
+			{
+				return false;
+			}
+
+			if (!connectivity.IsValid())
+			{
+				return false;
+			}
+		}
+
+		// Vertices not used by any triangle
+		while (next < vertexCount)
+		{
+			if (!decodeVertex(last))
+			{
+				return false;
+			}
+		}
+
+		if (!connectivity.IsAtEnd() || !coordinates.IsAtEnd())
+		{
+			return false;
+		}
+
+		// Dequantize
+		double scale[3];
+		int maxValue = (1 << positionBits) - 1;
+
+		for (auto j = 0; j < 3; ++j)
+		{
+			scale[j] = (double)boundsExtent[j] / maxValue;
+		}
+
+		Mesh::VertexContainer vertices;
+		Mesh::TriangleContainer triangles;
+
+		for (unsigned int i = 0; i < vertexCount; ++i)
+		{
+			vertices.insert(vertices.end(), std::make_pair((VertexId)i + 1, Vertex(Math::Vec3(
+				boundsMin[0] + ordered[i * 3 + 0] * scale[0],
+				boundsMin[1] + ordered[i * 3 + 1] * scale[1],
+				boundsMin[2] + ordered[i * 3 + 2] * scale[2]))));
+		}
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			triangles.push_back(Triangle(
+				(VertexId)indices[i + 0] + 1,
+				(VertexId)indices[i + 1] + 1,
+				(VertexId)indices[i + 2] + 1));
+		}
+
+		mesh.SetVertices(vertices);
+		mesh.SetTriangles(triangles);
+
+		return true;
+	}
+}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef _Terremesh_Remesh_CompressedMeshReader_H__
+#define _Terremesh_Remesh_CompressedMeshReader_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements compressed mesh reader.
+	///
+	/// @remarks
+	///		See CompressedMeshWriter for format. Whole stream is decoded in
+	///		single pass over memory, vertices get IDs in order of storage.
+	class CompressedMeshReader
+	{
+	public:
+		/// Creates instance of the CompressedMeshReader class.
+		///
+		/// @param[in] stream
+		///		The binary input stream.
+		CompressedMeshReader(std::istream& stream);
+
+		/// Reads mesh from stream.
+		///
+		/// @param[out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Read(Mesh& mesh, IProgressListener* listener);
+
+		/// Decodes mesh from memory.
+		///
+		/// @param[in] data
+		///		The encoded mesh.
+		/// @param[in] size
+		///		The size of encoded mesh.
+		/// @param[out] mesh
+		///		The mesh.
+		///
+		/// @retval true when successful.
+		/// @retval false when data is truncated or invalid.
+		static bool Decode(const unsigned char* data, size_t size, Mesh& mesh);
+
+	private:
+		CompressedMeshReader(const CompressedMeshReader&);
+		CompressedMeshReader& operator = (const CompressedMeshReader&);
+
+		std::istream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_CompressedMeshReader_H__ */
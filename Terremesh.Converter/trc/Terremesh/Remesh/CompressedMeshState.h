@@ -0,0 +1,166 @@
+#pragma once
+#ifndef _Terremesh_Remesh_CompressedMeshState_H__
+#define _Terremesh_Remesh_CompressedMeshState_H__
+
+#include "../Required.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements state shared by compressed mesh writer and reader.
+	///
+	/// @remarks
+	///		Both sides keep FIFOs of recent edges and vertices and update
+	///		them identically, so triangle can refer to shared edge and vertex
+	///		by their distance from most recent entry. Edge entry (A, B)
+	///		matches triangle with directed edge A->B, its neighbor across
+	///		the edge has vertex Opposite.
+	class CompressedMeshState
+	{
+	public:
+		/// The number of entries of each FIFO. Distance 15 is reserved as escape.
+		static const unsigned int FifoSize = 16;
+
+		/// Describes edge waiting for its neighbor triangle.
+		struct Edge
+		{
+			/// The first vertex of directed edge.
+			unsigned int A;
+
+			/// The second vertex of directed edge.
+			unsigned int B;
+
+			/// The vertex opposite to edge in emitted triangle.
+			unsigned int Opposite;
+		};
+
+		/// Creates instance of the CompressedMeshState class.
+		CompressedMeshState()
+			: m_EdgeCount(0)
+			, m_VertexCount(0)
+		{
+		}
+
+		/// Pushes edges of emitted triangle a->b->c, except edge a->b when it was shared.
+		///
+		/// @param[in] a
+		///		The first vertex.
+		/// @param[in] b
+		///		The second vertex.
+		/// @param[in] c
+		///		The third vertex.
+		/// @param[in] shared
+		///		The value indicating whether edge a->b was found in FIFO.
+		void PushTriangle(unsigned int a, unsigned int b, unsigned int c, bool shared)
+		{
+			if (!shared)
+			{
+				PushEdge(b, a, c);
+			}
+
+			PushEdge(c, b, a);
+			PushEdge(a, c, b);
+		}
+
+		/// Finds edge a->b.
+		///
+		/// @return
+		///		The distance from most recent edge, or -1.
+		int FindEdge(unsigned int a, unsigned int b) const
+		{
+			for (unsigned int i = 0; (i < FifoSize - 1) && (i < m_EdgeCount); ++i)
+			{
+				auto& edge = GetEdge(i);
+
+				if ((edge.A == a) && (edge.B == b))
+				{
+					return (int)i;
+				}
+			}
+
+			return -1;
+		}
+
+		/// Gets edge at distance from most recent one.
+		const Edge& GetEdge(unsigned int distance) const
+		{
+			return m_Edges[(m_EdgeCount - 1 - distance) % FifoSize];
+		}
+
+		/// Gets number of edges ever pushed.
+		unsigned int GetEdgeCount() const { return m_EdgeCount; }
+
+		/// Pushes vertex.
+		void PushVertex(unsigned int vertex)
+		{
+			m_Vertices[m_VertexCount++ % FifoSize] = vertex;
+		}
+
+		/// Finds vertex.
+		///
+		/// @return
+		///		The distance from most recent vertex, or -1.
+		///
+		/// @remarks
+		///		Vertex is coded as distance + 1, so only 14 most recent vertices are searched.
+		int FindVertex(unsigned int vertex) const
+		{
+			for (unsigned int i = 0; (i < FifoSize - 2) && (i < m_VertexCount); ++i)
+			{
+				if (GetVertex(i) == vertex)
+				{
+					return (int)i;
+				}
+			}
+
+			return -1;
+		}
+
+		/// Gets vertex at distance from most recent one.
+		unsigned int GetVertex(unsigned int distance) const
+		{
+			return m_Vertices[(m_VertexCount - 1 - distance) % FifoSize];
+		}
+
+		/// Gets number of vertices ever pushed.
+		unsigned int GetVertexCount() const { return m_VertexCount; }
+
+		/// Maps signed value to unsigned one, small magnitudes to small values.
+		static unsigned int EncodeZigZag(int value)
+		{
+			return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+		}
+
+		/// Maps unsigned value back to signed one.
+		static int DecodeZigZag(unsigned int value)
+		{
+			return (int)(value >> 1) ^ -(int)(value & 1);
+		}
+
+	private:
+		/// Pushes edge.
+		void PushEdge(unsigned int a, unsigned int b, unsigned int opposite)
+		{
+			auto& edge = m_Edges[m_EdgeCount++ % FifoSize];
+			edge.A = a;
+			edge.B = b;
+			edge.Opposite = opposite;
+		}
+
+		/// Edges FIFO.
+		Edge m_Edges[FifoSize];
+
+		/// The number of edges ever pushed.
+		unsigned int m_EdgeCount;
+
+		/// Vertices FIFO.
+		unsigned int m_Vertices[FifoSize];
+
+		/// The number of vertices ever pushed.
+		unsigned int m_VertexCount;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_CompressedMeshState_H__ */
@@ -0,0 +1,267 @@
+#include "CompressedMeshWriter.h"
+#include "CompressedMeshState.h"
+#include "VertexCacheOptimizer.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	CompressedMeshWriter::CompressedMeshWriter(std::ostream& stream, unsigned int positionBits)
+		: m_Stream(stream)
+		, m_PositionBits(std::min(std::max(positionBits, 1U), 24U))
+	{
+	}
+
+	void CompressedMeshWriter::AppendVarint(std::vector<unsigned char>& buffer, unsigned int value)
+	{
+		while (value >= 0x80)
+		{
+			buffer.push_back((unsigned char)(value | 0x80));
+			value >>= 7;
+		}
+
+		buffer.push_back((unsigned char)value);
+	}
+
+	void CompressedMeshWriter::Write(const Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Write compressed");
+		}
+
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		// Dense vertex indices
+		std::map<VertexId, unsigned int> dense;
+		std::vector<Math::Vec3> positions;
+
+		positions.reserve(vertices.size());
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			dense.insert(dense.end(), std::make_pair(it->first, (unsigned int)positions.size()));
+			positions.push_back(it->second.Position);
+		}
+
+		std::vector<unsigned int> indices;
+		indices.reserve(triangles.size() * 3);
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it)
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				indices.push_back(dense.find(it->Vertices[j])->second);
+			}
+		}
+
+		// Consecutive triangles of cache optimized order mostly share edges
+		VertexCacheOptimizer optimizer(CompressedMeshState::FifoSize);
+		optimizer.OptimizeTriangles(indices, positions.size());
+
+		// Quantize positions using bounds exactly as reader sees them
+		double limit = std::numeric_limits<double>::max();
+		double min[3] = { limit, limit, limit };
+		double max[3] = { -limit, -limit, -limit };
+
+		for (auto it = positions.begin(); it != positions.end(); ++it)
+		{
+			double p[3] = { it->X, it->Y, it->Z };
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				min[j] = std::min(min[j], p[j]);
+				max[j] = std::max(max[j], p[j]);
+			}
+		}
+
+		float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+		float boundsExtent[3] = { 0.0f, 0.0f, 0.0f };
+		int maxValue = (1 << m_PositionBits) - 1;
+
+		if (!positions.empty())
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				boundsMin[j] = (float)min[j];
+				boundsExtent[j] = (float)(max[j] - (double)boundsMin[j]);
+			}
+		}
+
+		std::vector<int> quantized(positions.size() * 3);
+
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			double p[3] = { positions[i].X, positions[i].Y, positions[i].Z };
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				double scaled = (boundsExtent[j] > 0.0f) ? (p[j] - boundsMin[j]) / boundsExtent[j] * maxValue : 0.0;
+				quantized[i * 3 + j] = std::min(std::max((int)(scaled + 0.5), 0), maxValue);
+			}
+		}
+
+		// Traverse triangles, numbering vertices by first use
+		const unsigned int unused = ~0U;
+		std::vector<unsigned int> remap(positions.size(), unused);
+		std::vector<int> ordered;
+		std::vector<unsigned char> connectivity;
+		std::vector<unsigned char> coordinates;
+		unsigned int next = 0;
+		int last[3] = { 0, 0, 0 };
+
+		ordered.reserve(quantized.size());
+		connectivity.reserve(triangles.size() * 2);
+		coordinates.reserve(positions.size() * 4);
+
+		auto emitVertex = [&](unsigned int vertex, const int* prediction)
+		{
+			remap[vertex] = next++;
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				int value = quantized[vertex * 3 + j];
+
+				AppendVarint(coordinates, CompressedMeshState::EncodeZigZag(value - prediction[j]));
+				ordered.push_back(value);
+				last[j] = value;
+			}
+		};
+
+		CompressedMeshState state;
+		size_t triangleCount = indices.size() / 3;
+
+		for (size_t i = 0; i < triangleCount; ++i)
+		{
+			if ((listener != nullptr) && ((i & 0xFFFF) == 0))
+			{
+				listener->OnStep((int)(i * 100 / triangleCount), 100);
+			}
+
+			const unsigned int* triangle = &indices[i * 3];
+			bool shared = false;
+
+			for (auto rotation = 0; (rotation < 3) && !shared; ++rotation)
+			{
+				auto a = triangle[rotation];
+				auto b = triangle[(rotation + 1) % 3];
+				auto c = triangle[(rotation + 2) % 3];
+
+				if ((remap[a] == unused) || (remap[b] == unused))
+				{
+					continue;
+				}
+
+				int distance = state.FindEdge(remap[a], remap[b]);
+
+				if (distance < 0)
+				{
+					continue;
+				}
+
+				shared = true;
+
+				unsigned char code = (unsigned char)(distance << 4);
+
+				if (remap[c] == unused)
+				{
+					// Parallelogram rule across shared edge
+					auto& edge = state.GetEdge(distance);
+					int prediction[3];
+
+					for (auto j = 0; j < 3; ++j)
+					{
+						prediction[j] = ordered[edge.A * 3 + j] + ordered[edge.B * 3 + j] - ordered[edge.Opposite * 3 + j];
+					}
+
+					emitVertex(c, prediction);
+					connectivity.push_back(code);
+					state.PushVertex(remap[c]);
+				}
+				else
+				{
+					int cached = state.FindVertex(remap[c]);
+
+					if (cached >= 0)
+					{
+						connectivity.push_back(code | (unsigned char)(cached + 1));
+					}
+					else
+					{
+						connectivity.push_back(code | 0x0F);
+						AppendVarint(connectivity, next - remap[c]);
+						state.PushVertex(remap[c]);
+					}
+				}
+
+				state.PushTriangle(remap[a], remap[b], remap[c], true);
+			}
+
+			if (shared)
+			{
+				continue;
+			}
+
+			connectivity.push_back(0xF0);
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				auto vertex = triangle[j];
+
+				if (remap[vertex] == unused)
+				{
+					AppendVarint(connectivity, 0);
+
+					int prediction[3] = { last[0], last[1], last[2] };
+					emitVertex(vertex, prediction);
+				}
+				else
+				{
+					AppendVarint(connectivity, next - remap[vertex]);
+				}
+
+				state.PushVertex(remap[vertex]);
+			}
+
+			state.PushTriangle(remap[triangle[0]], remap[triangle[1]], remap[triangle[2]], false);
+		}
+
+		// Vertices not used by any triangle follow in input order
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			if (remap[i] == unused)
+			{
+				int prediction[3] = { last[0], last[1], last[2] };
+				emitVertex((unsigned int)i, prediction);
+			}
+		}
+
+		m_Stream.write("TMC1", 4);
+		WriteValue((unsigned int)positions.size());
+		WriteValue((unsigned int)triangleCount);
+		WriteValue(m_PositionBits);
+
+		for (auto j = 0; j < 3; ++j)
+		{
+			WriteValue(boundsMin[j]);
+		}
+
+		for (auto j = 0; j < 3; ++j)
+		{
+			WriteValue(boundsExtent[j]);
+		}
+
+		WriteValue((unsigned int)connectivity.size());
+		WriteValue((unsigned int)coordinates.size());
+		m_Stream.write(reinterpret_cast<const char*>(connectivity.data()), connectivity.size());
+		m_Stream.write(reinterpret_cast<const char*>(coordinates.data()), coordinates.size());
+		m_Stream.flush();
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Write compressed");
+		}
+	}
+}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef _Terremesh_Remesh_CompressedMeshWriter_H__
+#define _Terremesh_Remesh_CompressedMeshWriter_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements compressed mesh writer.
+	///
+	/// @remarks
+	///		Positions are quantized on grid spanning bounding box of mesh.
+	///		Triangles are ordered for vertex cache locality, vertices are
+	///		stored in order of first use. Triangle sharing edge with recent
+	///		triangle takes single byte in most cases, its new vertex is
+	///		predicted by parallelogram rule. Other vertices are predicted by
+	///		previous vertex. All values are little endian:
+	///
+	///			char[4]   "TMC1"
+	///			uint32    vertex count
+	///			uint32    triangle count
+	///			uint32    position bits, 1 to 24
+	///			float[3]  bounding box minimum
+	///			float[3]  bounding box extent
+	///			uint32    connectivity stream size
+	///			uint32    position stream size
+	///			uint8     connectivity stream
+	///			uint8     position stream
+	///
+	///		Connectivity stream holds code byte per triangle. High nibble
+	///		below 15 is distance of shared edge in edge FIFO, low nibble
+	///		codes third vertex: 0 for new vertex, 1 to 14 for distance in
+	///		vertex FIFO plus one, 15 for explicit vertex. Code 0xF0 starts
+	///		triangle with three explicit vertices. Explicit vertex is varint
+	///		of next new vertex index minus vertex index, 0 for new vertex.
+	///
+	///		Position stream holds three zigzag varints per vertex, residuals
+	///		of quantized coordinates against prediction.
+	class CompressedMeshWriter
+	{
+	public:
+		/// Creates instance of the CompressedMeshWriter class.
+		///
+		/// @param[in] stream
+		///		The binary output stream.
+		/// @param[in] positionBits
+		///		The number of bits per quantized coordinate, 1 to 24.
+		CompressedMeshWriter(std::ostream& stream, unsigned int positionBits);
+
+		/// Writes mesh into stream.
+		///
+		/// @param[in] mesh
+		///		The mesh to write.
+		/// @param[in] listener
+		///		The progress listener.
+		void Write(const Mesh& mesh, IProgressListener* listener);
+
+	private:
+		CompressedMeshWriter(const CompressedMeshWriter&);
+		CompressedMeshWriter& operator = (const CompressedMeshWriter&);
+
+		/// Writes raw value into stream.
+		template <typename T>
+		void WriteValue(const T& value)
+		{
+			m_Stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		/// Appends variable length unsigned value to buffer.
+		static void AppendVarint(std::vector<unsigned char>& buffer, unsigned int value);
+
+		std::ostream& m_Stream;
+
+		/// The number of bits per coordinate.
+		unsigned int m_PositionBits;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_CompressedMeshWriter_H__ */
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef _Terremesh_Remesh_EdgeCollapse_H__
+#define _Terremesh_Remesh_EdgeCollapse_H__
+
+#include "../Required.h"
+#include "../Math/Vec3.h"
+#include "Vertex.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Describes single vertex pair collapse.
+	///
+	/// @remarks
+	///		Triangles are identified by their index in the input mesh.
+	struct EdgeCollapse
+	{
+	public:
+		/// Creates instance of the EdgeCollapse structure.
+		EdgeCollapse()
+			: Kept(0)
+			, Removed(0)
+			, Position(0.0, 0.0, 0.0)
+		{
+		}
+
+		/// The kept vertex ID.
+		VertexId Kept;
+
+		/// The removed vertex ID, merged into kept vertex.
+		VertexId Removed;
+
+		/// The new position of kept vertex.
+		Math::Vec3 Position;
+
+		/// The triangles removed by collapse.
+		std::vector<size_t> RemovedTriangles;
+
+		/// The triangles which had removed vertex replaced by kept vertex.
+		std::vector<size_t> ChangedTriangles;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_EdgeCollapse_H__ */
@@ -0,0 +1,232 @@
+#include "HeightmapReader.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	HeightmapReader::HeightmapReader(std::istream& stream, const HeightmapOptions& options)
+		: m_Stream(stream)
+		, m_Options(options)
+	{
+	}
+
+	bool HeightmapReader::Decode(const std::vector<char>& data, size_t& width, size_t& height, std::vector<float>& samples) const
+	{
+		size_t cursor = 0;
+
+		// Netpbm header token, skipping whitespace and comments
+		auto token = [&]() -> std::string
+		{
+			while (cursor < data.size())
+			{
+				if (data[cursor] == '#')
+				{
+					while ((cursor < data.size()) && (data[cursor] != '\n'))
+					{
+						++cursor;
+					}
+				}
+				else if (isspace((unsigned char)data[cursor]))
+				{
+					++cursor;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			size_t begin = cursor;
+
+			while ((cursor < data.size()) && !isspace((unsigned char)data[cursor]))
+			{
+				++cursor;
+			}
+
+			return std::string(data.begin() + begin, data.begin() + cursor);
+		};
+
+		bool pgm = (data.size() >= 3) && (data[0] == 'P') && (data[1] == '5') && isspace((unsigned char)data[2]);
+		bool pfm = (data.size() >= 3) && (data[0] == 'P') && (data[1] == 'f') && isspace((unsigned char)data[2]);
+
+		if (pgm || pfm)
+		{
+			token();
+			width = (size_t)atol(token().c_str());
+			height = (size_t)atol(token().c_str());
+			double parameter = atof(token().c_str());
+
+			// Single whitespace separates header from samples
+			++cursor;
+
+			size_t sampleSize = pfm ? 4 : (parameter > 255.0) ? 2 : 1;
+
+			if ((width == 0) || (height == 0) || (parameter == 0.0) || (cursor > data.size()) ||
+				((data.size() - cursor) / sampleSize / width < height))
+			{
+				return false;
+			}
+
+			samples.resize(width * height);
+
+			for (size_t y = 0; y < height; ++y)
+			{
+				// Rows of .pgm go from north, rows of .pfm from south
+				const unsigned char* row = reinterpret_cast<const unsigned char*>(data.data()) + cursor + (pfm ? y : height - 1 - y) * width * sampleSize;
+				float* target = &samples[y * width];
+
+				for (size_t x = 0; x < width; ++x)
+				{
+					const unsigned char* sample = row + x * sampleSize;
+
+					if (pfm)
+					{
+						// Negative scale marks little endian samples
+						unsigned char bytes[4];
+
+						for (auto i = 0; i < 4; ++i)
+						{
+							bytes[i] = sample[(parameter < 0.0) ? i : 3 - i];
+						}
+
+						memcpy(&target[x], bytes, sizeof(float));
+					}
+					else
+					{
+						target[x] = (sampleSize == 2) ? (float)((sample[0] << 8) | sample[1]) : (float)sample[0];
+					}
+				}
+			}
+
+			return true;
+		}
+
+		// Raw 16-bit samples, square unless size is given
+		size_t count = data.size() / 2;
+		width = m_Options.RawWidth;
+		height = m_Options.RawHeight;
+
+		if ((width == 0) || (height == 0))
+		{
+			width = (size_t)(std::sqrt((double)count) + 0.5);
+			height = width;
+		}
+
+		if ((width == 0) || (data.size() % 2 != 0) || (count / width != height) || (count % width != 0))
+		{
+			return false;
+		}
+
+		samples.resize(count);
+
+		for (size_t y = 0; y < height; ++y)
+		{
+			const unsigned char* row = reinterpret_cast<const unsigned char*>(data.data()) + (height - 1 - y) * width * 2;
+			float* target = &samples[y * width];
+
+			for (size_t x = 0; x < width; ++x)
+			{
+				target[x] = (float)(row[x * 2] | (row[x * 2 + 1] << 8));
+			}
+		}
+
+		return true;
+	}
+
+	bool HeightmapReader::Read(Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Read heightmap");
+		}
+
+		mesh.Clear();
+
+		std::vector<char> data;
+		char buffer[1 << 16];
+
+		while (m_Stream.read(buffer, sizeof(buffer)) || (m_Stream.gcount() > 0))
+		{
+			data.insert(data.end(), buffer, buffer + m_Stream.gcount());
+		}
+
+		size_t width = 0;
+		size_t height = 0;
+		std::vector<float> samples;
+
+		// Vertex IDs must fit
+		bool valid = Decode(data, width, height, samples) && (samples.size() < (size_t)std::numeric_limits<VertexId>::max());
+
+		std::vector<char>().swap(data);
+
+		if (valid)
+		{
+			Mesh::VertexContainer vertices;
+			Mesh::TriangleContainer triangles;
+
+			for (size_t y = 0; y < height; ++y)
+			{
+				for (size_t x = 0; x < width; ++x)
+				{
+					double sample = samples[y * width + x];
+
+					if (std::isfinite(sample))
+					{
+						vertices.insert(vertices.end(), std::make_pair((VertexId)(y * width + x) + 1, Vertex(Math::Vec3(
+							m_Options.Origin.X + x * m_Options.SpacingX,
+							m_Options.Origin.Y + y * m_Options.SpacingY,
+							m_Options.Origin.Z + sample * m_Options.HeightScale))));
+					}
+				}
+			}
+
+			// Cells are split along diagonal from south-west corner
+			for (size_t y = 0; y + 1 < height; ++y)
+			{
+				if ((listener != nullptr) && ((y & 0xFF) == 0))
+				{
+					listener->OnStep((int)(y * 100 / height), 100);
+				}
+
+				for (size_t x = 0; x + 1 < width; ++x)
+				{
+					size_t a = y * width + x;
+					size_t b = a + 1;
+					size_t c = a + width;
+					size_t d = c + 1;
+
+					bool finiteA = std::isfinite(samples[a]);
+					bool finiteD = std::isfinite(samples[d]);
+
+					if (finiteA && std::isfinite(samples[b]) && finiteD)
+					{
+						triangles.push_back(Triangle((VertexId)a + 1, (VertexId)b + 1, (VertexId)d + 1));
+					}
+
+					if (finiteA && finiteD && std::isfinite(samples[c]))
+					{
+						triangles.push_back(Triangle((VertexId)a + 1, (VertexId)d + 1, (VertexId)c + 1));
+					}
+				}
+			}
+
+			mesh.SetVertices(vertices);
+			mesh.SetTriangles(triangles);
+		}
+		else
+		{
+			std::cerr << "Invalid heightmap" << std::endl;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Read heightmap");
+		}
+
+		return valid;
+	}
+}
+}
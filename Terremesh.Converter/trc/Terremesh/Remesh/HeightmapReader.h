@@ -0,0 +1,140 @@
+#pragma once
+#ifndef _Terremesh_Remesh_HeightmapReader_H__
+#define _Terremesh_Remesh_HeightmapReader_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Describes placement of heightmap grid.
+	struct HeightmapOptions
+	{
+	public:
+		/// Creates instance of the HeightmapOptions structure.
+		HeightmapOptions()
+			: Origin(0.0, 0.0, 0.0)
+			, SpacingX(1.0)
+			, SpacingY(1.0)
+			, HeightScale(1.0)
+			, RawWidth(0)
+			, RawHeight(0)
+		{
+		}
+
+		/// The position of south-west grid corner at zero height.
+		Math::Vec3 Origin;
+
+		/// The distance between columns along X axis.
+		double SpacingX;
+
+		/// The distance between rows along Y axis.
+		double SpacingY;
+
+		/// The scale of samples along Z axis.
+		double HeightScale;
+
+		/// The number of columns of raw heightmap, 0 for square one.
+		unsigned int RawWidth;
+
+		/// The number of rows of raw heightmap, 0 for square one.
+		unsigned int RawHeight;
+
+		/// Formats placement as result cache options.
+		///
+		/// @return
+		///		The options, empty for default placement.
+		std::string FormatOptions() const
+		{
+			std::ostringstream options;
+			options.precision(17);
+
+			if ((Origin.X != 0.0) || (Origin.Y != 0.0) || (Origin.Z != 0.0))
+			{
+				options << "origin=" << Origin.X << "," << Origin.Y << "," << Origin.Z;
+			}
+
+			if ((SpacingX != 1.0) || (SpacingY != 1.0))
+			{
+				options << (options.tellp() > 0 ? ";" : "") << "spacing=" << SpacingX << "," << SpacingY;
+			}
+
+			if (HeightScale != 1.0)
+			{
+				options << (options.tellp() > 0 ? ";" : "") << "height-scale=" << HeightScale;
+			}
+
+			if ((RawWidth != 0) || (RawHeight != 0))
+			{
+				options << (options.tellp() > 0 ? ";" : "") << "raster=" << RawWidth << "," << RawHeight;
+			}
+
+			return options.str();
+		}
+	};
+
+	/// Implements heightmap raster reader.
+	///
+	/// @remarks
+	///		Three rasters are read:
+	///
+	///			P5 .pgm   8 or 16-bit samples, big endian, top row first
+	///			Pf .pfm   float samples, endianness by sign of scale, bottom row first
+	///			.raw      16-bit little endian samples, top row first
+	///
+	///		Grid mesh is built directly from samples: each sample becomes
+	///		vertex, each cell two triangles facing +Z. Vertex of column x and
+	///		row y, counted from south-west corner, has ID y * width + x + 1.
+	///		Non-finite float samples mark holes, no vertex or triangle is
+	///		created for them.
+	class HeightmapReader
+	{
+	public:
+		/// Creates instance of the HeightmapReader class.
+		///
+		/// @param[in] stream
+		///		The binary input stream.
+		/// @param[in] options
+		///		The grid placement.
+		HeightmapReader(std::istream& stream, const HeightmapOptions& options);
+
+		/// Reads mesh from stream.
+		///
+		/// @param[out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Read(Mesh& mesh, IProgressListener* listener);
+
+	private:
+		HeightmapReader(const HeightmapReader&);
+		HeightmapReader& operator = (const HeightmapReader&);
+
+		/// Decodes samples of raster.
+		///
+		/// @param[in] data
+		///		The raster file contents.
+		/// @param[out] width
+		///		The number of columns.
+		/// @param[out] height
+		///		The number of rows.
+		/// @param[out] samples
+		///		The samples, south row first.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Decode(const std::vector<char>& data, size_t& width, size_t& height, std::vector<float>& samples) const;
+
+		std::istream& m_Stream;
+		HeightmapOptions m_Options;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_HeightmapReader_H__ */
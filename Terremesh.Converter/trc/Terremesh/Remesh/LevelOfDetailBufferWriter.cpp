@@ -0,0 +1,170 @@
+#include "LevelOfDetailBufferWriter.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	LevelOfDetailBufferWriter::LevelOfDetailBufferWriter(std::ofstream& stream)
+		: m_Stream(stream)
+		, m_Mismatch(false)
+		, m_Optimizer(nullptr)
+	{
+	}
+
+	void LevelOfDetailBufferWriter::OnSnapshot(size_t index, const Mesh& mesh)
+	{
+		if (m_Levels.size() <= index)
+		{
+			m_Levels.resize(index + 1);
+		}
+
+		auto& level = m_Levels[index];
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		level.Vertices.clear();
+		level.Indices.clear();
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			auto inserted = m_Positions.insert(std::make_pair(it->first, it->second.Position));
+
+			if (!inserted.second && (inserted.first->second != it->second.Position))
+			{
+				m_Mismatch = true;
+			}
+
+			level.Vertices.push_back(it->first);
+		}
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it)
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				level.Indices.push_back(it->Vertices[j]);
+			}
+		}
+	}
+
+	bool LevelOfDetailBufferWriter::Write(IProgressListener* listener)
+	{
+		if (m_Mismatch)
+		{
+			return false;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Write level of detail buffers");
+		}
+
+		// Rank vertices by size of coarsest level using them
+		std::map<VertexId, size_t> ranks;
+
+		for (auto level = m_Levels.begin(); level != m_Levels.end(); ++level)
+		{
+			for (auto it = level->Vertices.begin(); it != level->Vertices.end(); ++it)
+			{
+				auto inserted = ranks.insert(std::make_pair(*it, level->Vertices.size()));
+
+				if (!inserted.second)
+				{
+					inserted.first->second = std::min(inserted.first->second, level->Vertices.size());
+				}
+			}
+		}
+
+		std::vector<std::pair<size_t, VertexId> > order;
+		order.reserve(ranks.size());
+
+		for (auto it = ranks.begin(); it != ranks.end(); ++it)
+		{
+			order.push_back(std::make_pair(it->second, it->first));
+		}
+
+		std::sort(order.begin(), order.end());
+
+		std::map<VertexId, unsigned int> indices;
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			indices.insert(std::make_pair(order[i].second, (unsigned int)i));
+		}
+
+		unsigned int indexSize = (order.size() <= 0x10000) ? 2 : 4;
+
+		m_Stream.write("TLB1", 4);
+		WriteValue((unsigned int)order.size());
+		WriteValue((unsigned int)m_Levels.size());
+		WriteValue(indexSize);
+
+		for (auto it = order.begin(); it != order.end(); ++it)
+		{
+			auto& position = m_Positions[it->second];
+
+			WriteValue((float)position.X);
+			WriteValue((float)position.Y);
+			WriteValue((float)position.Z);
+		}
+
+		int total = (int)m_Levels.size();
+
+		for (int i = 0; i < total; ++i)
+		{
+			if (listener != nullptr)
+			{
+				listener->OnStep(i + 1, total);
+			}
+
+			auto& level = m_Levels[i];
+
+			// Level uses prefix ending at its last vertex
+			unsigned int used = 0;
+
+			for (auto it = level.Vertices.begin(); it != level.Vertices.end(); ++it)
+			{
+				used = std::max(used, indices[*it] + 1);
+			}
+
+			std::vector<unsigned int> buffer;
+			buffer.reserve(level.Indices.size());
+
+			for (auto it = level.Indices.begin(); it != level.Indices.end(); ++it)
+			{
+				buffer.push_back(indices[*it]);
+			}
+
+			if (m_Optimizer != nullptr)
+			{
+				m_Optimizer->OptimizeTriangles(buffer, used);
+			}
+
+			WriteValue(used);
+			WriteValue((unsigned int)(buffer.size() / 3));
+
+			for (auto it = buffer.begin(); it != buffer.end(); ++it)
+			{
+				unsigned int index = *it;
+
+				if (indexSize == 2)
+				{
+					WriteValue((unsigned short)index);
+				}
+				else
+				{
+					WriteValue(index);
+				}
+			}
+		}
+
+		m_Stream.flush();
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Write level of detail buffers");
+		}
+
+		return true;
+	}
+}
+}
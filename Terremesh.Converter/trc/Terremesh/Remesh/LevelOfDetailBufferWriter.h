@@ -0,0 +1,100 @@
+#pragma once
+#ifndef _Terremesh_Remesh_LevelOfDetailBufferWriter_H__
+#define _Terremesh_Remesh_LevelOfDetailBufferWriter_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "../ISnapshotListener.h"
+#include "Mesh.h"
+#include "VertexCacheOptimizer.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements writer of levels of detail sharing single vertex buffer.
+	///
+	/// @remarks
+	///		Writer collects snapshots of remeshing with endpoint placement,
+	///		where every level indexes subset of input vertices. Vertices are
+	///		ordered by coarsest level using them, so each level uses prefix
+	///		of vertex buffer. All values are little endian:
+	///
+	///			char[4]   "TLB1"
+	///			uint32    vertex count
+	///			uint32    level count
+	///			uint32    index size, 2 or 4 bytes
+	///			float[3]  vertex positions
+	///			levels, in targets order:
+	///				uint32    used vertex count
+	///				uint32    triangle count
+	///				index[3]  triangle vertex indices
+	class LevelOfDetailBufferWriter
+		: public ISnapshotListener
+	{
+	public:
+		/// Creates instance of the LevelOfDetailBufferWriter class.
+		///
+		/// @param[in] stream
+		///		The binary output stream.
+		LevelOfDetailBufferWriter(std::ofstream& stream);
+
+		virtual void OnSnapshot(size_t index, const Mesh& mesh);
+
+		/// Sets optimizer reordering triangles of each level.
+		///
+		/// @param[in] value
+		///		The vertex cache optimizer, or nullptr to keep triangle order.
+		///
+		/// @remarks
+		///		Vertex order is shared by all levels, so only triangles are reordered.
+		void SetVertexCacheOptimizer(const VertexCacheOptimizer* value) { m_Optimizer = value; }
+
+		/// Writes vertex buffer and index buffers into stream.
+		///
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false when levels place same vertex at different positions.
+		bool Write(IProgressListener* listener);
+
+	private:
+		LevelOfDetailBufferWriter(const LevelOfDetailBufferWriter&);
+		LevelOfDetailBufferWriter& operator = (const LevelOfDetailBufferWriter&);
+
+		/// Describes collected level of detail.
+		struct Level
+		{
+			/// Vertex IDs.
+			std::vector<VertexId> Vertices;
+
+			/// Triangle vertex IDs.
+			std::vector<VertexId> Indices;
+		};
+
+		/// Writes raw value into stream.
+		template <typename T>
+		void WriteValue(const T& value)
+		{
+			m_Stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		std::ofstream& m_Stream;
+
+		/// Positions of vertices used by any level.
+		std::map<VertexId, Math::Vec3> m_Positions;
+
+		/// Collected levels, by target index.
+		std::vector<Level> m_Levels;
+
+		/// Set when levels disagree on vertex position.
+		bool m_Mismatch;
+
+		/// The vertex cache optimizer or nullptr.
+		const VertexCacheOptimizer* m_Optimizer;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_LevelOfDetailBufferWriter_H__ */
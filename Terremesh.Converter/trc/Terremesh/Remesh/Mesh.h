@@ -16,7 +16,7 @@ namespace Remesh
 	{
 	public:
 		/// Vertex container type.
-		typedef std::map<int, Vertex> VertexContainer;
+		typedef std::map<VertexId, Vertex> VertexContainer;
 
 		/// Triangle container type.
 		typedef std::deque<Triangle> TriangleContainer;
@@ -45,11 +45,12 @@ namespace Remesh
 		///		The vertex container.
 		void SetVertices(const VertexContainer& vertices) { m_Vertices = vertices; }
 
-		/// Invalidate all planes.
-		///
-		/// @remarks
-		///		Recompute all normals and planes for triangles.
-		void InvalidatePlanes();
+		/// Removes all vertices and triangles.
+		void Clear()
+		{
+			m_Triangles.clear();
+			m_Vertices.clear();
+		}
 
 	private:
 		/// Triangles container.
@@ -0,0 +1,261 @@
+#include "MeshFile.h"
+#include "MeshReader.h"
+#include "MeshWriter.h"
+#include "CompressedMeshReader.h"
+#include "CompressedMeshWriter.h"
+#include "PlyMeshReader.h"
+#include "PlyMeshWriter.h"
+#include "StlMeshReader.h"
+#include "StlMeshWriter.h"
+#include "../IO/FileStream.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Checks whether path ends with extension, ignoring case.
+	static bool HasExtension(const std::string& path, const char* extension)
+	{
+		size_t length = strlen(extension);
+
+		if (path.size() < length)
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < length; ++i)
+		{
+			if (tolower((unsigned char)path[path.size() - length + i]) != extension[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	MeshFormat MeshFile::GetFormat(const std::string& path)
+	{
+		auto contentsPath = IO::FilePath::GetContentsPath(path);
+
+		if (HasExtension(contentsPath, ".tmc"))
+		{
+			return MeshFormat_Compressed;
+		}
+
+		if (HasExtension(contentsPath, ".ply"))
+		{
+			return MeshFormat_Ply;
+		}
+
+		if (HasExtension(contentsPath, ".stl"))
+		{
+			return MeshFormat_Stl;
+		}
+
+		if (HasExtension(contentsPath, ".pgm") || HasExtension(contentsPath, ".pfm") ||
+			HasExtension(contentsPath, ".raw") || HasExtension(contentsPath, ".r16"))
+		{
+			return MeshFormat_Heightmap;
+		}
+
+		return MeshFormat_Obj;
+	}
+
+	MeshFormat MeshFile::DetectFormat(std::istream& stream, const std::string& path)
+	{
+		auto start = stream.tellg();
+
+		if (start == std::istream::pos_type(-1))
+		{
+			return GetFormat(path);
+		}
+
+		// Binary .stl has 80 bytes of free text and triangle count
+		char header[84];
+		stream.read(header, sizeof(header));
+		size_t read = (size_t)stream.gcount();
+
+		stream.clear();
+		stream.seekg(0, std::ios::end);
+		auto end = stream.tellg();
+
+		stream.clear();
+		stream.seekg(start);
+
+		if ((read >= 4) && (memcmp(header, "TMC1", 4) == 0))
+		{
+			return MeshFormat_Compressed;
+		}
+
+		if ((read >= 4) && (memcmp(header, "ply", 3) == 0) && ((header[3] == '\n') || (header[3] == '\r')))
+		{
+			return MeshFormat_Ply;
+		}
+
+		if ((read >= 3) && (header[0] == 'P') && ((header[1] == '5') || (header[1] == 'f')) && isspace((unsigned char)header[2]))
+		{
+			return MeshFormat_Heightmap;
+		}
+
+		if (read == sizeof(header))
+		{
+			unsigned int count = 0;
+			memcpy(&count, header + 80, sizeof(count));
+
+			if (end != std::istream::pos_type(-1))
+			{
+				if ((unsigned long long)(end - start) == 84ULL + 50ULL * count)
+				{
+					return MeshFormat_Stl;
+				}
+			}
+			else if (count != 0)
+			{
+				// Size of pipe is unknown, but text never holds binary triangle count
+				for (size_t i = 80; i < sizeof(header); ++i)
+				{
+					if (!isprint((unsigned char)header[i]) && !isspace((unsigned char)header[i]))
+					{
+						return MeshFormat_Stl;
+					}
+				}
+			}
+		}
+
+		return GetFormat(path);
+	}
+
+	std::string MeshFile::FormatOptions(const std::string& path, unsigned int positionBits)
+	{
+		std::ostringstream options;
+
+		switch (GetFormat(path))
+		{
+		case MeshFormat_Compressed:
+			options << "format=tmc;bits=" << positionBits;
+			break;
+		case MeshFormat_Ply:
+			options << "format=ply";
+			break;
+		case MeshFormat_Stl:
+			options << "format=stl";
+			break;
+		default:
+			break;
+		}
+
+		// Cached file is stored as written
+		switch (IO::FilePath::GetCompression(path))
+		{
+		case IO::Compression_Gzip:
+			options << (options.tellp() > 0 ? ";" : "") << "compression=gz";
+			break;
+		case IO::Compression_Zstd:
+			options << (options.tellp() > 0 ? ";" : "") << "compression=zst";
+			break;
+		default:
+			break;
+		}
+
+		return options.str();
+	}
+
+	bool MeshFile::Read(std::istream& stream, MeshFormat format, Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler)
+	{
+		return Read(stream, format, HeightmapOptions(), mesh, listener, scheduler);
+	}
+
+	bool MeshFile::Read(std::istream& stream, MeshFormat format, const HeightmapOptions& heightmap, Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler)
+	{
+		if (format == MeshFormat_Heightmap)
+		{
+			HeightmapReader reader(stream, heightmap);
+			return reader.Read(mesh, listener);
+		}
+
+		if (format == MeshFormat_Compressed)
+		{
+			CompressedMeshReader reader(stream);
+			return reader.Read(mesh, listener);
+		}
+
+		if (format == MeshFormat_Ply)
+		{
+			PlyMeshReader reader(stream);
+			return reader.Read(mesh, listener);
+		}
+
+		if (format == MeshFormat_Stl)
+		{
+			StlMeshReader reader(stream);
+			return reader.Read(mesh, listener);
+		}
+
+		// Text parser skips anything it does not understand, so binary data yields no faces
+		bool empty = std::istream::traits_type::eq_int_type(stream.peek(), std::istream::traits_type::eof());
+		stream.clear();
+
+		MeshReader reader(stream);
+		reader.Read(mesh, listener, scheduler);
+
+		if (!empty && mesh.GetTriangles().empty())
+		{
+			std::cerr << "Invalid OBJ mesh" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool MeshFile::Write(const Mesh& mesh, const std::string& path, unsigned int positionBits, IProgressListener* listener, Threading::TaskScheduler* scheduler)
+	{
+		auto format = GetFormat(path);
+
+		if (format == MeshFormat_Heightmap)
+		{
+			return false;
+		}
+
+		// Plain .obj file is written in parallel at block offsets
+		if ((format == MeshFormat_Obj) && (scheduler != nullptr) && (scheduler->GetThreadCount() > 1) &&
+			(IO::FilePath::GetCompression(path) == IO::Compression_None) && !IO::FilePath::IsStandardStream(path))
+		{
+			return MeshWriter::WriteFile(mesh, path, listener, scheduler);
+		}
+
+		IO::OutputFileStream stream(path, format != MeshFormat_Obj);
+
+		if (!stream.IsOpen())
+		{
+			return false;
+		}
+
+		if (format == MeshFormat_Obj)
+		{
+			MeshWriter writer(stream);
+			writer.Write(mesh, listener, scheduler);
+		}
+		else if (format == MeshFormat_Compressed)
+		{
+			CompressedMeshWriter writer(stream, positionBits);
+			writer.Write(mesh, listener);
+		}
+		else if (format == MeshFormat_Ply)
+		{
+			PlyMeshWriter writer(stream);
+			writer.Write(mesh, listener);
+		}
+		else
+		{
+			StlMeshWriter writer(stream);
+			writer.Write(mesh, listener);
+		}
+
+		return stream.Close();
+	}
+}
+}
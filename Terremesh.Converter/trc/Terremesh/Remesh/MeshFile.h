@@ -0,0 +1,141 @@
+#pragma once
+#ifndef _Terremesh_Remesh_MeshFile_H__
+#define _Terremesh_Remesh_MeshFile_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "../Threading/TaskScheduler.h"
+#include "Mesh.h"
+#include "HeightmapReader.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Specifies mesh file format.
+	enum MeshFormat
+	{
+		/// Wavefront .obj text.
+		MeshFormat_Obj,
+
+		/// Compressed .tmc binary.
+		MeshFormat_Compressed,
+
+		/// Binary .ply.
+		MeshFormat_Ply,
+
+		/// Binary .stl.
+		MeshFormat_Stl,
+
+		/// Heightmap raster .pgm, .pfm or .raw, read only.
+		MeshFormat_Heightmap,
+	};
+
+	/// Implements reading and writing of meshes in format chosen by file name or contents.
+	class MeshFile
+	{
+	public:
+		/// The default number of bits per quantized coordinate of compressed format.
+		static const unsigned int DefaultPositionBits = 16;
+
+		/// Gets format of file.
+		///
+		/// @param[in] path
+		///		The file path. Extensions ".tmc", ".ply" and ".stl" select their
+		///		formats regardless of case, ".pgm", ".pfm", ".raw" and ".r16"
+		///		select heightmap, any other .obj. Compression extension ".gz"
+		///		or ".zst" is skipped.
+		///
+		/// @return
+		///		The format.
+		static MeshFormat GetFormat(const std::string& path);
+
+		/// Detects format of input stream from its contents.
+		///
+		/// @param[in] stream
+		///		The binary input stream, left at its starting position.
+		/// @param[in] path
+		///		The file path, whose extension decides when contents are not
+		///		recognized or stream cannot seek.
+		///
+		/// @return
+		///		The format.
+		///
+		/// @remarks
+		///		Compressed, .ply, .pgm and .pfm files are recognized by their
+		///		signatures, binary .stl by size matching its triangle count.
+		///		Size of standard input or decompressed stream is unknown, so
+		///		binary .stl is recognized there by triangle count, which is not
+		///		text unless file holds hundreds of millions of triangles.
+		static MeshFormat DetectFormat(std::istream& stream, const std::string& path);
+
+		/// Formats options of output file as result cache options.
+		///
+		/// @param[in] path
+		///		The output file path, whose extensions select format and compression.
+		/// @param[in] positionBits
+		///		The number of bits per quantized coordinate.
+		///
+		/// @return
+		///		The options, empty for uncompressed .obj.
+		static std::string FormatOptions(const std::string& path, unsigned int positionBits);
+
+		/// Reads mesh from stream.
+		///
+		/// @param[in] stream
+		///		The input stream.
+		/// @param[in] format
+		///		The stream format.
+		/// @param[out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler or nullptr.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		static bool Read(std::istream& stream, MeshFormat format, Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler);
+
+		/// Reads mesh from stream, placing heightmap grid as given.
+		///
+		/// @param[in] stream
+		///		The input stream.
+		/// @param[in] format
+		///		The stream format.
+		/// @param[in] heightmap
+		///		The heightmap grid placement.
+		/// @param[out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler or nullptr.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		static bool Read(std::istream& stream, MeshFormat format, const HeightmapOptions& heightmap, Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler);
+
+		/// Writes mesh into file.
+		///
+		/// @param[in] mesh
+		///		The mesh.
+		/// @param[in] path
+		///		The file path, whose extension selects format. File ending with
+		///		".gz" or ".zst" is compressed while written. Heightmaps cannot
+		///		be written.
+		/// @param[in] positionBits
+		///		The number of bits per quantized coordinate of compressed format.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler or nullptr.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		static bool Write(const Mesh& mesh, const std::string& path, unsigned int positionBits, IProgressListener* listener, Threading::TaskScheduler* scheduler);
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_MeshFile_H__ */
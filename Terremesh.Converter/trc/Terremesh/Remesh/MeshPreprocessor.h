@@ -0,0 +1,107 @@
+#pragma once
+#ifndef _Terremesh_Remesh_MeshPreprocessor_H__
+#define _Terremesh_Remesh_MeshPreprocessor_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "../Threading/TaskScheduler.h"
+#include "Mesh.h"
+#include "MeshReorderer.h"
+#include "MeshWelder.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements optional stages applied to mesh after reading.
+	///
+	/// @remarks
+	///		Vertices are welded first, then mesh is reordered.
+	class MeshPreprocessor
+	{
+	public:
+		/// Creates instance of the MeshPreprocessor class.
+		MeshPreprocessor()
+			: m_WeldEpsilon(-1.0)
+			, m_Curve(SpaceFillingCurve_None)
+		{
+		}
+
+		/// Gets welding grid cell size.
+		///
+		/// @return
+		///		The cell size, negative when welding is disabled.
+		double GetWeldEpsilon() const { return m_WeldEpsilon; }
+
+		/// Sets welding grid cell size.
+		///
+		/// @param[in] value
+		///		The cell size. Zero welds exactly equal positions only,
+		///		negative disables welding.
+		void SetWeldEpsilon(double value) { m_WeldEpsilon = value; }
+
+		/// Gets space-filling curve used to reorder mesh.
+		///
+		/// @return
+		///		The space-filling curve.
+		SpaceFillingCurve GetCurve() const { return m_Curve; }
+
+		/// Sets space-filling curve used to reorder mesh.
+		///
+		/// @param[in] value
+		///		The space-filling curve.
+		void SetCurve(SpaceFillingCurve value) { m_Curve = value; }
+
+		/// Applies enabled stages to mesh.
+		///
+		/// @param[in,out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler or nullptr.
+		void Process(Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler) const
+		{
+			if (m_WeldEpsilon >= 0.0)
+			{
+				MeshWelder welder(m_WeldEpsilon);
+				welder.Weld(mesh, listener, scheduler);
+			}
+
+			MeshReorderer reorderer(m_Curve);
+			reorderer.Reorder(mesh, listener, scheduler);
+		}
+
+		/// Formats enabled stages as result cache options.
+		///
+		/// @return
+		///		The options, empty when no stage is enabled.
+		std::string FormatOptions() const
+		{
+			std::ostringstream options;
+			options.precision(17);
+
+			if (m_WeldEpsilon >= 0.0)
+			{
+				options << "weld=" << m_WeldEpsilon;
+			}
+
+			if (m_Curve != SpaceFillingCurve_None)
+			{
+				options << (options.tellp() > 0 ? ";" : "") << "reorder=" << MeshReorderer::GetCurveName(m_Curve);
+			}
+
+			return options.str();
+		}
+
+	private:
+		/// The welding grid cell size.
+		double m_WeldEpsilon;
+
+		/// The space-filling curve.
+		SpaceFillingCurve m_Curve;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_MeshPreprocessor_H__ */
@@ -1,61 +1,131 @@
 #include "MeshReader.h"
 #include "Triangle.h"
 #include "Vertex.h"
+#include "../IO/MemoryStreamBuffer.h"
 
 namespace Terremesh
 {
 namespace Remesh
 {
-	MeshReader::MeshReader(std::ifstream& stream)
+	/// Minimal size of input block parsed by single task.
+	static const size_t MinBlockSize = 1 << 20;
+
+	MeshReader::MeshReader(std::istream& stream)
 		: m_Stream(stream)
 	{
 	}
 
-	void MeshReader::Read(Mesh& mesh, IProgressListener* listener)
+	void MeshReader::Read(Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler)
 	{
 		if (listener != nullptr)
 		{
 			listener->OnStarted("Read");
 		}
 
-		std::string keyword;
-		
-		Triangle triangle;
-		Vertex vertex;
-
 		Mesh::TriangleContainer triangles;
 		Mesh::VertexContainer vertices;
 
-		int verticesCount = 0;
+		if ((scheduler == nullptr) || (scheduler->GetThreadCount() == 1))
+		{
+			std::vector<Vertex> blockVertices;
+			Parse(m_Stream, blockVertices, triangles);
 
-		while (m_Stream.good() && (m_Stream >> keyword))
+			for (size_t i = 0; i < blockVertices.size(); ++i)
+			{
+				vertices.insert(vertices.end(), std::make_pair((VertexId)i + 1, blockVertices[i]));
+			}
+		}
+		else
 		{
-			if (keyword == "v")
+			// Load whole input and parse blocks of lines in parallel
+			std::vector<char> contents;
+			char buffer[1 << 16];
+
+			while (m_Stream.read(buffer, sizeof(buffer)) || (m_Stream.gcount() > 0))
 			{
-				m_Stream >> vertex.Position.X >> vertex.Position.Y >> vertex.Position.Z;
-				vertices.insert(std::make_pair(++verticesCount, vertex));
+				contents.insert(contents.end(), buffer, buffer + m_Stream.gcount());
+			}
 
+			size_t blockSize = std::max(MinBlockSize, contents.size() / (scheduler->GetThreadCount() * 4) + 1);
+			std::vector<size_t> bounds(1, 0);
+
+			while (bounds.back() < contents.size())
+			{
+				size_t end = std::min(bounds.back() + blockSize, contents.size());
+
+				// Blocks end after line break
+				while ((end < contents.size()) && (contents[end - 1] != '\n'))
+				{
+					++end;
+				}
+
+				bounds.push_back(end);
 			}
 
-			if (keyword == "f")
+			size_t blocks = bounds.size() - 1;
+			std::vector<std::vector<Vertex> > blockVertices(blocks);
+			std::vector<Mesh::TriangleContainer> blockTriangles(blocks);
+
+			scheduler->ParallelFor(0, blocks, 1,
+				[&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						IO::MemoryStreamBuffer blockBuffer(contents.data() + bounds[i], bounds[i + 1] - bounds[i]);
+						std::istream blockStream(&blockBuffer);
+
+						Parse(blockStream, blockVertices[i], blockTriangles[i]);
+					}
+				});
+
+			// Vertex IDs continue across blocks
+			VertexId verticesCount = 0;
+
+			for (size_t i = 0; i < blocks; ++i)
 			{
-				m_Stream >> triangle.Vertices[0] >> triangle.Vertices[1] >> triangle.Vertices[2];
+				for (auto it = blockVertices[i].begin(); it != blockVertices[i].end(); ++it)
+				{
+					vertices.insert(vertices.end(), std::make_pair(++verticesCount, *it));
+				}
 
-				triangles.push_back(triangle);
+				triangles.insert(triangles.end(), blockTriangles[i].begin(), blockTriangles[i].end());
 			}
-			
-			// Ignore other stuff
 		}
-		// Ended parsing stuff
 
 		mesh.SetTriangles(triangles);
 		mesh.SetVertices(vertices);
-		mesh.InvalidatePlanes();
 
 		if (listener != nullptr)
 		{
 			listener->OnCompleted("Read");
 		}
 	}
+
+	void MeshReader::Parse(std::istream& stream, std::vector<Vertex>& vertices, Mesh::TriangleContainer& triangles)
+	{
+		std::string keyword;
+		
+		Triangle triangle;
+		Vertex vertex;
+
+		while (stream.good() && (stream >> keyword))
+		{
+			if (keyword == "v")
+			{
+				stream >> vertex.Position.X >> vertex.Position.Y >> vertex.Position.Z;
+				vertices.push_back(vertex);
+			}
+
+			if (keyword == "f")
+			{
+				stream >> triangle.Vertices[0] >> triangle.Vertices[1] >> triangle.Vertices[2];
+
+				triangles.push_back(triangle);
+			}
+			
+			// Ignore other stuff
+		}
+		// Ended parsing stuff
+	}
+}
 }
-}
\ No newline at end of file
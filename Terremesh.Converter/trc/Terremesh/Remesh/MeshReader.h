@@ -4,6 +4,7 @@
 
 #include "../Required.h"
 #include "../IProgressListener.h"
+#include "../Threading/TaskScheduler.h"
 #include "Mesh.h"
 
 namespace Terremesh
@@ -18,7 +19,7 @@ namespace Remesh
 		///
 		/// @param[in] stream
 		///		The input stream.
-		MeshReader(std::ifstream& stream);
+		MeshReader(std::istream& stream);
 		
 		/// Reads mesh from stream.
 		///
@@ -26,13 +27,25 @@ namespace Remesh
 		///		The mesh.
 		/// @param[in] listener
 		///		The progress listener.
-		void Read(Mesh& mesh, IProgressListener* listener);
+		/// @param[in] scheduler
+		///		The scheduler parsing blocks of input in parallel, or nullptr.
+		void Read(Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler);
 
 	private:
 		MeshReader(const MeshReader&);
 		MeshReader& operator = (const MeshReader&);
 
-		std::ifstream& m_Stream;
+		/// Parses vertices and triangles from stream.
+		///
+		/// @param[in,out] stream
+		///		The input stream.
+		/// @param[out] vertices
+		///		The vertices, in order of appearance.
+		/// @param[out] triangles
+		///		The triangles.
+		static void Parse(std::istream& stream, std::vector<Vertex>& vertices, Mesh::TriangleContainer& triangles);
+
+		std::istream& m_Stream;
 	};
 }
 }
@@ -0,0 +1,216 @@
+#include "MeshReorderer.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// The number of bits of quantized coordinate.
+	static const int CoordinateBits = 21;
+
+	/// Spreads bits of coordinate to every third bit.
+	static unsigned long long SpreadBits(unsigned int value)
+	{
+		unsigned long long x = value & 0x1fffff;
+
+		x = (x | (x << 32)) & 0x001f00000000ffffULL;
+		x = (x | (x << 16)) & 0x001f0000ff0000ffULL;
+		x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+		x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+		x = (x | (x << 2)) & 0x1249249249249249ULL;
+
+		return x;
+	}
+
+	MeshReorderer::MeshReorderer(SpaceFillingCurve curve)
+		: m_Curve(curve)
+	{
+	}
+
+	void MeshReorderer::Reorder(Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler) const
+	{
+		if (m_Curve == SpaceFillingCurve_None)
+		{
+			return;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Reorder");
+		}
+
+		auto& vertices = mesh.GetVertices();
+
+		std::vector<std::pair<unsigned long long, VertexId> > order;
+		std::vector<const Vertex*> positions;
+
+		order.reserve(vertices.size());
+		positions.reserve(vertices.size());
+
+		// Bounding cube of vertices
+		double limit = std::numeric_limits<double>::max();
+
+		Math::Vec3 min(limit, limit, limit);
+		Math::Vec3 max(-limit, -limit, -limit);
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			auto& p = it->second.Position;
+
+			min = Math::Vec3(std::min(min.X, p.X), std::min(min.Y, p.Y), std::min(min.Z, p.Z));
+			max = Math::Vec3(std::max(max.X, p.X), std::max(max.Y, p.Y), std::max(max.Z, p.Z));
+
+			order.push_back(std::make_pair(0ULL, it->first));
+			positions.push_back(&it->second);
+		}
+
+		double extent = std::max(std::max(max.X - min.X, max.Y - min.Y), max.Z - min.Z);
+		double scale = (extent > 0.0) ? (double)((1 << CoordinateBits) - 1) / extent : 0.0;
+
+		Threading::ParallelFor(scheduler, 0, order.size(), 16384,
+			[&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					auto& p = positions[i]->Position;
+
+					auto x = (unsigned int)((p.X - min.X) * scale);
+					auto y = (unsigned int)((p.Y - min.Y) * scale);
+					auto z = (unsigned int)((p.Z - min.Z) * scale);
+
+					order[i].first = (m_Curve == SpaceFillingCurve_Hilbert)
+						? ComputeHilbert(x, y, z)
+						: ComputeMorton(x, y, z);
+				}
+			});
+
+		// Equal codes keep input order
+		std::sort(order.begin(), order.end());
+
+		// Renumber vertices in curve order
+		Mesh::VertexContainer reordered;
+		std::map<VertexId, VertexId> ids;
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			VertexId id = (VertexId)i + 1;
+
+			reordered.insert(reordered.end(), std::make_pair(id, vertices.find(order[i].second)->second));
+			ids.insert(std::make_pair(order[i].second, id));
+		}
+
+		std::vector<Triangle> triangles(mesh.GetTriangles().begin(), mesh.GetTriangles().end());
+
+		Threading::ParallelFor(scheduler, 0, triangles.size(), 16384,
+			[&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					for (auto j = 0; j < 3; ++j)
+					{
+						triangles[i].Vertices[j] = ids.find(triangles[i].Vertices[j])->second;
+					}
+				}
+			});
+
+		// Sort triangles by lowest vertex, keeping winding
+		std::stable_sort(triangles.begin(), triangles.end(),
+			[](const Triangle& lhs, const Triangle& rhs)
+			{
+				return std::min(std::min(lhs.Vertices[0], lhs.Vertices[1]), lhs.Vertices[2])
+					< std::min(std::min(rhs.Vertices[0], rhs.Vertices[1]), rhs.Vertices[2]);
+			});
+
+		mesh.SetVertices(reordered);
+		mesh.SetTriangles(Mesh::TriangleContainer(triangles.begin(), triangles.end()));
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Reorder");
+		}
+	}
+
+	bool MeshReorderer::ParseCurve(const std::string& name, SpaceFillingCurve& curve)
+	{
+		if (name == "morton")
+		{
+			curve = SpaceFillingCurve_Morton;
+			return true;
+		}
+
+		if (name == "hilbert")
+		{
+			curve = SpaceFillingCurve_Hilbert;
+			return true;
+		}
+
+		return false;
+	}
+
+	std::string MeshReorderer::GetCurveName(SpaceFillingCurve curve)
+	{
+		switch (curve)
+		{
+		case SpaceFillingCurve_Morton:
+			return "morton";
+
+		case SpaceFillingCurve_Hilbert:
+			return "hilbert";
+
+		default:
+			return "";
+		}
+	}
+
+	unsigned long long MeshReorderer::ComputeMorton(unsigned int x, unsigned int y, unsigned int z)
+	{
+		return SpreadBits(x) | (SpreadBits(y) << 1) | (SpreadBits(z) << 2);
+	}
+
+	unsigned long long MeshReorderer::ComputeHilbert(unsigned int x, unsigned int y, unsigned int z)
+	{
+		// Skilling's transform of coordinates into transposed Hilbert index
+		unsigned int axes[3] = { x, y, z };
+
+		for (unsigned int q = 1u << (CoordinateBits - 1); q > 1; q >>= 1)
+		{
+			unsigned int p = q - 1;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				if (axes[i] & q)
+				{
+					axes[0] ^= p;
+				}
+				else
+				{
+					unsigned int t = (axes[0] ^ axes[i]) & p;
+					axes[0] ^= t;
+					axes[i] ^= t;
+				}
+			}
+		}
+
+		// Gray encode
+		axes[1] ^= axes[0];
+		axes[2] ^= axes[1];
+
+		unsigned int t = 0;
+
+		for (unsigned int q = 1u << (CoordinateBits - 1); q > 1; q >>= 1)
+		{
+			if (axes[2] & q)
+			{
+				t ^= q - 1;
+			}
+		}
+
+		for (int i = 0; i < 3; ++i)
+		{
+			axes[i] ^= t;
+		}
+
+		// Transposed index interleaves with first axis most significant
+		return (SpreadBits(axes[0]) << 2) | (SpreadBits(axes[1]) << 1) | SpreadBits(axes[2]);
+	}
+}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef _Terremesh_Remesh_MeshReorderer_H__
+#define _Terremesh_Remesh_MeshReorderer_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "../Threading/TaskScheduler.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Specifies space-filling curve used to order vertices.
+	enum SpaceFillingCurve
+	{
+		/// Vertices keep input order.
+		SpaceFillingCurve_None,
+
+		/// Z-order curve.
+		SpaceFillingCurve_Morton,
+
+		/// Hilbert curve.
+		SpaceFillingCurve_Hilbert,
+	};
+
+	/// Implements spatial reordering of mesh vertices and triangles.
+	///
+	/// @remarks
+	///		Vertices are renumbered along space-filling curve through their
+	///		bounding cube, then triangles are sorted by their lowest vertex.
+	///		Neighbouring vertices and triangles of spatially random input
+	///		end up close in memory, which keeps one-ring walks in cache.
+	class MeshReorderer
+	{
+	public:
+		/// Creates instance of the MeshReorderer class.
+		///
+		/// @param[in] curve
+		///		The space-filling curve.
+		MeshReorderer(SpaceFillingCurve curve);
+
+		/// Reorders mesh.
+		///
+		/// @param[in,out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler computing curve positions in parallel, or nullptr.
+		void Reorder(Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler) const;
+
+		/// Parses space-filling curve name.
+		///
+		/// @param[in] name
+		///		The curve name, "morton" or "hilbert".
+		/// @param[out] curve
+		///		The curve.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		static bool ParseCurve(const std::string& name, SpaceFillingCurve& curve);
+
+		/// Gets space-filling curve name.
+		///
+		/// @param[in] curve
+		///		The curve.
+		///
+		/// @return
+		///		The curve name, empty for SpaceFillingCurve_None.
+		static std::string GetCurveName(SpaceFillingCurve curve);
+
+	private:
+		/// Computes Morton code of quantized point.
+		static unsigned long long ComputeMorton(unsigned int x, unsigned int y, unsigned int z);
+
+		/// Computes Hilbert index of quantized point.
+		static unsigned long long ComputeHilbert(unsigned int x, unsigned int y, unsigned int z);
+
+		/// The space-filling curve.
+		SpaceFillingCurve m_Curve;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_MeshReorderer_H__ */
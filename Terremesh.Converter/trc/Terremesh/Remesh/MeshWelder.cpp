@@ -0,0 +1,170 @@
+#include "MeshWelder.h"
+
+#include <cstring>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Gets bits of coordinate, treating both zeros as equal.
+	static long long GetBits(double value)
+	{
+		long long bits = 0;
+
+		value = (value == 0.0) ? 0.0 : value;
+		memcpy(&bits, &value, sizeof(bits));
+
+		return bits;
+	}
+
+	MeshWelder::MeshWelder(double epsilon)
+		: m_Epsilon(epsilon)
+	{
+	}
+
+	size_t MeshWelder::Weld(Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler) const
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Weld");
+		}
+
+		auto& vertices = mesh.GetVertices();
+
+		std::vector<const Mesh::VertexContainer::value_type*> entries;
+		entries.reserve(vertices.size());
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			entries.push_back(&*it);
+		}
+
+		std::vector<Key> keys(entries.size());
+
+		Threading::ParallelFor(scheduler, 0, keys.size(), 16384,
+			[&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					ComputeKey(entries[i]->second.Position, keys[i]);
+					keys[i].Id = entries[i]->first;
+				}
+			});
+
+		// Group equal keys, lowest ID first
+		std::sort(keys.begin(), keys.end(),
+			[](const Key& lhs, const Key& rhs)
+			{
+				if (lhs.Hash != rhs.Hash)
+				{
+					return lhs.Hash < rhs.Hash;
+				}
+
+				for (auto i = 0; i < 3; ++i)
+				{
+					if (lhs.Cell[i] != rhs.Cell[i])
+					{
+						return lhs.Cell[i] < rhs.Cell[i];
+					}
+				}
+
+				return lhs.Id < rhs.Id;
+			});
+
+		// Map each vertex to first vertex of its group
+		std::vector<VertexId> targets(vertices.empty() ? 0 : (size_t)vertices.rbegin()->first + 1, 0);
+		size_t merged = 0;
+
+		for (size_t i = 0, group = 0; i < keys.size(); ++i)
+		{
+			if ((keys[i].Hash != keys[group].Hash) ||
+				(keys[i].Cell[0] != keys[group].Cell[0]) ||
+				(keys[i].Cell[1] != keys[group].Cell[1]) ||
+				(keys[i].Cell[2] != keys[group].Cell[2]))
+			{
+				group = i;
+			}
+			else if (i != group)
+			{
+				++merged;
+			}
+
+			targets[keys[i].Id] = keys[group].Id;
+		}
+
+		std::vector<Triangle> triangles(mesh.GetTriangles().begin(), mesh.GetTriangles().end());
+		std::vector<char> degenerate(triangles.size(), 0);
+
+		Threading::ParallelFor(scheduler, 0, triangles.size(), 16384,
+			[&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					auto& v = triangles[i].Vertices;
+
+					for (auto j = 0; j < 3; ++j)
+					{
+						v[j] = (v[j] < (VertexId)targets.size()) ? targets[v[j]] : 0;
+					}
+
+					degenerate[i] = (v[0] == v[1]) || (v[1] == v[2]) || (v[2] == v[0]);
+				}
+			});
+
+		// Keep triangles and vertices which still make sense
+		Mesh::TriangleContainer welded;
+		std::vector<char> referenced(targets.size(), 0);
+
+		for (size_t i = 0; i < triangles.size(); ++i)
+		{
+			if (!degenerate[i])
+			{
+				welded.push_back(triangles[i]);
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					referenced[triangles[i].Vertices[j]] = 1;
+				}
+			}
+		}
+
+		Mesh::VertexContainer kept;
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			if (referenced[it->first])
+			{
+				kept.insert(kept.end(), *it);
+			}
+		}
+
+		mesh.SetVertices(kept);
+		mesh.SetTriangles(welded);
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Weld");
+		}
+
+		return merged;
+	}
+
+	void MeshWelder::ComputeKey(const Math::Vec3& position, Key& key) const
+	{
+		double coordinates[3] = { position.X, position.Y, position.Z };
+
+		// Combine cell coordinates into hash
+		key.Hash = 0xcbf29ce484222325ULL;
+
+		for (auto i = 0; i < 3; ++i)
+		{
+			key.Cell[i] = (m_Epsilon > 0.0)
+				? (long long)std::floor(coordinates[i] / m_Epsilon)
+				: GetBits(coordinates[i]);
+
+			key.Hash = (key.Hash ^ (unsigned long long)key.Cell[i]) * 0x100000001b3ULL;
+			key.Hash ^= key.Hash >> 29;
+		}
+	}
+}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef _Terremesh_Remesh_MeshWelder_H__
+#define _Terremesh_Remesh_MeshWelder_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "../Threading/TaskScheduler.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements merging of coincident mesh vertices.
+	///
+	/// @remarks
+	///		Vertices are keyed by their exact position or by position quantized
+	///		to grid of epsilon sized cells. Vertices sharing key are replaced by
+	///		the one with lowest ID. Triangles which collapse into edge or point
+	///		are removed, as are vertices no longer referenced by any triangle.
+	class MeshWelder
+	{
+	public:
+		/// Creates instance of the MeshWelder class.
+		///
+		/// @param[in] epsilon
+		///		The grid cell size. Zero welds exactly equal positions only.
+		MeshWelder(double epsilon);
+
+		/// Welds mesh vertices.
+		///
+		/// @param[in,out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler computing keys and remapping triangles in parallel, or nullptr.
+		///
+		/// @return
+		///		The number of merged vertices.
+		size_t Weld(Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler) const;
+
+	private:
+		/// Describes vertex position key.
+		struct Key
+		{
+			/// The hash of cell.
+			unsigned long long Hash;
+
+			/// The cell coordinates.
+			long long Cell[3];
+
+			/// The vertex ID.
+			VertexId Id;
+		};
+
+		/// Computes key of position.
+		void ComputeKey(const Math::Vec3& position, Key& key) const;
+
+		/// The grid cell size.
+		double m_Epsilon;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_MeshWelder_H__ */
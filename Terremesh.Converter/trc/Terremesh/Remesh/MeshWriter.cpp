@@ -1,16 +1,28 @@
 #include "MeshWriter.h"
+#include "../IO/PositionalFile.h"
 
 
 namespace Terremesh
 {
 namespace Remesh
 {
-	MeshWriter::MeshWriter(std::ofstream& stream)
+	/// The number of lines formatted by single task.
+	static const size_t LinesPerBlock = 16384;
+
+#ifdef _WIN32
+	/// The line end of file written in text mode.
+	static const char* const TextLineEnd = "\r\n";
+#else
+	/// The line end of file written in text mode.
+	static const char* const TextLineEnd = "\n";
+#endif
+
+	MeshWriter::MeshWriter(std::ostream& stream)
 		: m_Stream(stream)
 	{
 	}
 
-	void MeshWriter::Write(const Mesh& mesh, IProgressListener* listener)
+	void MeshWriter::Write(const Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler)
 	{
 		if (listener != nullptr)
 		{
@@ -20,35 +32,169 @@ namespace Remesh
 		auto& vertices = mesh.GetVertices();
 		auto& triangles = mesh.GetTriangles();
 
+		if ((scheduler == nullptr) || (scheduler->GetThreadCount() == 1))
+		{
+			// Remap indices
+			std::map<VertexId, VertexId> ids;
+
+			VertexId id = 1;
+
+			for (auto it = vertices.begin(); it != vertices.end(); ++it)
+			{
+				auto& v = it->second.Position;
+
+				m_Stream << "v " << v.X << " " << v.Y << " " << v.Z << std::endl;
+				ids.insert(std::make_pair(it->first, id));
+				++id;
+			}
+
+			for (auto it = triangles.begin(); it != triangles.end(); ++it)
+			{			
+				auto& t = it->Vertices;
+
+				VertexId t0 = ids[t[0]];
+				VertexId t1 = ids[t[1]];
+				VertexId t2 = ids[t[2]];
+
+				m_Stream << "f " << t0 << " " << t1 << " " << t2 << std::endl;
+			}
+		}
+		else
+		{
+			std::vector<std::string> blocks;
+			Format(mesh, "\n", blocks, scheduler);
+
+			for (auto it = blocks.begin(); it != blocks.end(); ++it)
+			{
+				m_Stream.write(it->data(), it->size());
+			}
+
+			m_Stream.flush();
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Write");
+		}
+	}
+
+	void MeshWriter::Format(const Mesh& mesh, const char* lineEnd, std::vector<std::string>& blocks, Threading::TaskScheduler* scheduler)
+	{
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
 		// Remap indices
 		std::map<VertexId, VertexId> ids;
+		std::vector<const Vertex*> ordered;
 
 		VertexId id = 1;
 
 		for (auto it = vertices.begin(); it != vertices.end(); ++it)
 		{
-			auto& v = it->second.Position;
-
-			m_Stream << "v " << v.X << " " << v.Y << " " << v.Z << std::endl;
-			ids.insert(std::make_pair(it->first, id));
+			ordered.push_back(&it->second);
+			ids.insert(ids.end(), std::make_pair(it->first, id));
 			++id;
 		}
 
-		for (auto it = triangles.begin(); it != triangles.end(); ++it)
-		{			
-			auto& t = it->Vertices;
+		// Format blocks of lines in parallel
+		size_t vertexBlocks = (ordered.size() + LinesPerBlock - 1) / LinesPerBlock;
+		size_t triangleBlocks = (triangles.size() + LinesPerBlock - 1) / LinesPerBlock;
+		blocks.assign(vertexBlocks + triangleBlocks, std::string());
+
+		Threading::ParallelFor(scheduler, 0, blocks.size(), 1,
+			[&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					std::ostringstream block;
+
+					if (i < vertexBlocks)
+					{
+						size_t last = std::min((i + 1) * LinesPerBlock, ordered.size());
+
+						for (size_t j = i * LinesPerBlock; j < last; ++j)
+						{
+							auto& v = ordered[j]->Position;
+
+							block << "v " << v.X << " " << v.Y << " " << v.Z << lineEnd;
+						}
+					}
+					else
+					{
+						size_t first = (i - vertexBlocks) * LinesPerBlock;
+						size_t last = std::min(first + LinesPerBlock, triangles.size());
+
+						for (size_t j = first; j < last; ++j)
+						{
+							auto& t = triangles[j].Vertices;
+							auto t0 = ids.find(t[0]);
+							auto t1 = ids.find(t[1]);
+							auto t2 = ids.find(t[2]);
+
+							block << "f "
+								<< (t0 != ids.end() ? t0->second : 0) << " "
+								<< (t1 != ids.end() ? t1->second : 0) << " "
+								<< (t2 != ids.end() ? t2->second : 0) << lineEnd;
+						}
+					}
+
+					blocks[i] = block.str();
+				}
+			});
+	}
+
+	bool MeshWriter::WriteFile(const Mesh& mesh, const std::string& path, IProgressListener* listener, Threading::TaskScheduler* scheduler)
+	{
+		IO::PositionalFile file(path);
+
+		if (!file.IsOpen())
+		{
+			return false;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Write");
+		}
+
+		std::vector<std::string> blocks;
+		Format(mesh, TextLineEnd, blocks, scheduler);
 
-			VertexId t0 = ids[t[0]];
-			VertexId t1 = ids[t[1]];
-			VertexId t2 = ids[t[2]];
+		// Block offsets are prefix sums of block sizes
+		std::vector<unsigned long long> offsets(blocks.size() + 1, 0);
 
-			m_Stream << "f " << t0 << " " << t1 << " " << t2 << std::endl;
+		for (size_t i = 0; i < blocks.size(); ++i)
+		{
+			offsets[i + 1] = offsets[i] + blocks[i].size();
 		}
 
+		std::atomic<bool> failed(!file.Resize(offsets.back()));
+
+		if (!failed)
+		{
+			Threading::ParallelFor(scheduler, 0, blocks.size(), 1,
+				[&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						if (!file.Write(offsets[i], blocks[i].data(), blocks[i].size()))
+						{
+							failed = true;
+						}
+
+						std::string().swap(blocks[i]);
+					}
+				});
+		}
+
+		bool result = file.Close() && !failed;
+
 		if (listener != nullptr)
 		{
 			listener->OnCompleted("Write");
 		}
+
+		return result;
 	}
 }
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include "../Required.h"
 #include "Mesh.h"
 #include "../IProgressListener.h"
+#include "../Threading/TaskScheduler.h"
 
 namespace Terremesh
 {
@@ -18,7 +19,7 @@ namespace Remesh
 		///
 		/// @param[in] stream
 		///		The output stream.
-		MeshWriter(std::ofstream& stream);
+		MeshWriter(std::ostream& stream);
 
 		/// Writes mesh into stream.
 		///
@@ -26,13 +27,47 @@ namespace Remesh
 		///		The mesh to write.
 		/// @param[in] listener
 		///		The progress listener.
-		void Write(const Mesh& mesh, IProgressListener* listener);
+		/// @param[in] scheduler
+		///		The scheduler formatting blocks of output in parallel, or nullptr.
+		void Write(const Mesh& mesh, IProgressListener* listener, Threading::TaskScheduler* scheduler);
+
+		/// Writes mesh into plain file.
+		///
+		/// @param[in] mesh
+		///		The mesh to write.
+		/// @param[in] path
+		///		The file path.
+		/// @param[in] listener
+		///		The progress listener.
+		/// @param[in] scheduler
+		///		The scheduler formatting and writing blocks of output in parallel.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		///
+		/// @remarks
+		///		Offsets of blocks are prefix sums of their sizes, so the file is
+		///		sized once and blocks are written concurrently at their offsets.
+		///		The file is identical to the one written into stream.
+		static bool WriteFile(const Mesh& mesh, const std::string& path, IProgressListener* listener, Threading::TaskScheduler* scheduler);
 
 	private:
 		MeshWriter(const MeshWriter&);
 		MeshWriter& operator = (const MeshWriter&);
 
-		std::ofstream& m_Stream;
+		/// Formats blocks of vertex and face lines in parallel.
+		///
+		/// @param[in] mesh
+		///		The mesh to format.
+		/// @param[in] lineEnd
+		///		The line end.
+		/// @param[out] blocks
+		///		The blocks of lines, in output order.
+		/// @param[in] scheduler
+		///		The scheduler.
+		static void Format(const Mesh& mesh, const char* lineEnd, std::vector<std::string>& blocks, Threading::TaskScheduler* scheduler);
+
+		std::ostream& m_Stream;
 	};
 }
 }
@@ -0,0 +1,331 @@
+#include "MeshletBuilder.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	MeshletBuilder::MeshletBuilder(unsigned int maxVertices, unsigned int maxTriangles)
+		: m_MaxVertices(std::min(std::max(maxVertices, 3U), 256U))
+		, m_MaxTriangles(std::max(maxTriangles, 1U))
+	{
+	}
+
+	void MeshletBuilder::Build(const Mesh& mesh, MeshletSet& result, IProgressListener* listener) const
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Build meshlets");
+		}
+
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		result.Positions.clear();
+		result.Meshlets.clear();
+		result.Vertices.clear();
+		result.Triangles.clear();
+
+		// Dense vertex indices
+		std::map<VertexId, unsigned int> dense;
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			dense.insert(dense.end(), std::make_pair(it->first, (unsigned int)result.Positions.size()));
+			result.Positions.push_back(it->second.Position);
+		}
+
+		size_t vertexCount = result.Positions.size();
+		size_t triangleCount = triangles.size();
+		std::vector<unsigned int> indices;
+
+		indices.reserve(triangleCount * 3);
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it)
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				indices.push_back(dense.find(it->Vertices[j])->second);
+			}
+		}
+
+		// Triangles adjacent to each vertex
+		std::vector<size_t> offsets(vertexCount + 1, 0);
+
+		for (auto it = indices.begin(); it != indices.end(); ++it)
+		{
+			++offsets[*it + 1];
+		}
+
+		for (size_t i = 1; i < offsets.size(); ++i)
+		{
+			offsets[i] += offsets[i - 1];
+		}
+
+		std::vector<size_t> adjacency(offsets.back());
+		std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			adjacency[fill[indices[i]]++] = i / 3;
+		}
+
+		std::vector<char> assigned(triangleCount, 0);
+		std::vector<int> local(vertexCount, -1);
+
+		Meshlet meshlet;
+		Math::Vec3 sum;
+
+		auto addTriangle = [&](size_t triangle)
+		{
+			assigned[triangle] = 1;
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				auto vertex = indices[triangle * 3 + j];
+
+				if (local[vertex] < 0)
+				{
+					local[vertex] = (int)meshlet.VertexCount++;
+					result.Vertices.push_back(vertex);
+					Math::Vec3::Add(sum, sum, result.Positions[vertex]);
+				}
+
+				result.Triangles.push_back((unsigned char)local[vertex]);
+			}
+
+			++meshlet.TriangleCount;
+		};
+
+		auto countNew = [&](size_t triangle)
+		{
+			auto a = indices[triangle * 3 + 0];
+			auto b = indices[triangle * 3 + 1];
+			auto c = indices[triangle * 3 + 2];
+
+			return (unsigned int)(
+				(local[a] < 0 ? 1 : 0) +
+				((local[b] < 0) && (b != a) ? 1 : 0) +
+				((local[c] < 0) && (c != a) && (c != b) ? 1 : 0));
+		};
+
+		size_t done = 0;
+
+		for (size_t seed = 0; seed < triangleCount; ++seed)
+		{
+			if (assigned[seed])
+			{
+				continue;
+			}
+
+			meshlet = Meshlet();
+			meshlet.VertexOffset = (unsigned int)result.Vertices.size();
+			meshlet.TriangleOffset = (unsigned int)(result.Triangles.size() / 3);
+			sum = Math::Vec3(0.0, 0.0, 0.0);
+
+			addTriangle(seed);
+
+			while (meshlet.TriangleCount < m_MaxTriangles)
+			{
+				Math::Vec3 center(
+					sum.X / meshlet.VertexCount,
+					sum.Y / meshlet.VertexCount,
+					sum.Z / meshlet.VertexCount);
+
+				size_t best = triangleCount;
+				unsigned int bestNew = 0;
+				double bestDistance = 0.0;
+
+				// Grow through triangles sharing vertex with meshlet
+				for (auto v = meshlet.VertexOffset; v < meshlet.VertexOffset + meshlet.VertexCount; ++v)
+				{
+					auto vertex = result.Vertices[v];
+
+					for (size_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i)
+					{
+						auto triangle = adjacency[i];
+
+						if (assigned[triangle])
+						{
+							continue;
+						}
+
+						auto added = countNew(triangle);
+
+						if (meshlet.VertexCount + added > m_MaxVertices)
+						{
+							continue;
+						}
+
+						Math::Vec3 centroid(0.0, 0.0, 0.0);
+
+						for (auto j = 0; j < 3; ++j)
+						{
+							Math::Vec3::Add(centroid, centroid, result.Positions[indices[triangle * 3 + j]]);
+						}
+
+						Math::Vec3 offset(centroid.X / 3.0 - center.X, centroid.Y / 3.0 - center.Y, centroid.Z / 3.0 - center.Z);
+						double distance = offset.LengthSquared();
+
+						if ((best == triangleCount) ||
+							(added < bestNew) ||
+							((added == bestNew) && ((distance < bestDistance) || ((distance == bestDistance) && (triangle < best)))))
+						{
+							best = triangle;
+							bestNew = added;
+							bestDistance = distance;
+						}
+					}
+				}
+
+				if (best == triangleCount)
+				{
+					break;
+				}
+
+				addTriangle(best);
+			}
+
+			for (auto v = meshlet.VertexOffset; v < meshlet.VertexOffset + meshlet.VertexCount; ++v)
+			{
+				local[result.Vertices[v]] = -1;
+			}
+
+			ComputeBounds(result, meshlet);
+			result.Meshlets.push_back(meshlet);
+
+			done += meshlet.TriangleCount;
+
+			if (listener != nullptr)
+			{
+				listener->OnStep((int)(done * 100 / triangleCount), 100);
+			}
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Build meshlets");
+		}
+	}
+
+	void MeshletBuilder::ComputeBounds(const MeshletSet& set, Meshlet& meshlet)
+	{
+		auto position = [&](unsigned int v) -> const Math::Vec3&
+		{
+			return set.Positions[set.Vertices[meshlet.VertexOffset + v]];
+		};
+
+		// Ritter's sphere: span between distant points, grown over outliers
+		auto first = position(0);
+		unsigned int far1 = 0;
+		unsigned int far2 = 0;
+
+		for (unsigned int v = 0; v < meshlet.VertexCount; ++v)
+		{
+			if (Math::Vec3::Distance(position(v), first) > Math::Vec3::Distance(position(far1), first))
+			{
+				far1 = v;
+			}
+		}
+
+		for (unsigned int v = 0; v < meshlet.VertexCount; ++v)
+		{
+			if (Math::Vec3::Distance(position(v), position(far1)) > Math::Vec3::Distance(position(far2), position(far1)))
+			{
+				far2 = v;
+			}
+		}
+
+		Math::Vec3 center;
+		Math::Vec3::Center(center, position(far1), position(far2));
+		double radius = 0.5 * Math::Vec3::Distance(position(far1), position(far2));
+
+		for (unsigned int v = 0; v < meshlet.VertexCount; ++v)
+		{
+			double distance = Math::Vec3::Distance(position(v), center);
+
+			if (distance > radius)
+			{
+				double grown = 0.5 * (radius + distance);
+				double shift = (grown - radius) / distance;
+
+				center.X += (position(v).X - center.X) * shift;
+				center.Y += (position(v).Y - center.Y) * shift;
+				center.Z += (position(v).Z - center.Z) * shift;
+				radius = grown;
+			}
+		}
+
+		meshlet.Center = center;
+		meshlet.Radius = radius;
+
+		// Normal cone around average of triangle normals, each kept with its corner
+		std::vector<std::pair<Math::Vec3, Math::Vec3> > normals;
+		Math::Vec3 axis(0.0, 0.0, 0.0);
+
+		for (unsigned int t = meshlet.TriangleOffset; t < meshlet.TriangleOffset + meshlet.TriangleCount; ++t)
+		{
+			auto& p0 = position(set.Triangles[t * 3 + 0]);
+			auto& p1 = position(set.Triangles[t * 3 + 1]);
+			auto& p2 = position(set.Triangles[t * 3 + 2]);
+
+			Math::Vec3 edge1;
+			Math::Vec3 edge2;
+			Math::Vec3::Subtract(edge1, p1, p0);
+			Math::Vec3::Subtract(edge2, p2, p0);
+
+			Math::Vec3 normal(
+				edge1.Y * edge2.Z - edge1.Z * edge2.Y,
+				edge1.Z * edge2.X - edge1.X * edge2.Z,
+				edge1.X * edge2.Y - edge1.Y * edge2.X);
+
+			// Degenerate triangles do not face any direction
+			if (normal.Length() > 0.0)
+			{
+				normal.Normalize();
+				normals.push_back(std::make_pair(normal, p0));
+				Math::Vec3::Add(axis, axis, normal);
+			}
+		}
+
+		meshlet.ConeApex = center;
+		meshlet.ConeAxis = Math::Vec3(0.0, 0.0, 1.0);
+		meshlet.ConeCutoff = 1.0;
+
+		if (normals.empty() || !(axis.Length() > 0.0))
+		{
+			return;
+		}
+
+		axis.Normalize();
+
+		double minDot = 1.0;
+
+		for (auto it = normals.begin(); it != normals.end(); ++it)
+		{
+			minDot = std::min(minDot, Math::Vec3::Dot(it->first, axis));
+		}
+
+		meshlet.ConeAxis = axis;
+
+		// Cones wider than hemisphere are never culled
+		if (minDot <= 0.1)
+		{
+			return;
+		}
+
+		// Move apex back until every triangle plane lies in front of it
+		double maxOffset = 0.0;
+
+		for (auto it = normals.begin(); it != normals.end(); ++it)
+		{
+			Math::Vec3 toCenter;
+			Math::Vec3::Subtract(toCenter, center, it->second);
+
+			maxOffset = std::max(maxOffset, Math::Vec3::Dot(toCenter, it->first) / Math::Vec3::Dot(axis, it->first));
+		}
+
+		meshlet.ConeApex = Math::Vec3(center.X - axis.X * maxOffset, center.Y - axis.Y * maxOffset, center.Z - axis.Z * maxOffset);
+		meshlet.ConeCutoff = std::sqrt(1.0 - minDot * minDot);
+	}
+}
+}
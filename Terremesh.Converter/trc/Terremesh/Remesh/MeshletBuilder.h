@@ -0,0 +1,135 @@
+#pragma once
+#ifndef _Terremesh_Remesh_MeshletBuilder_H__
+#define _Terremesh_Remesh_MeshletBuilder_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Describes cluster of triangles culled as one.
+	struct Meshlet
+	{
+	public:
+		/// Creates instance of the Meshlet structure.
+		Meshlet()
+			: VertexOffset(0)
+			, VertexCount(0)
+			, TriangleOffset(0)
+			, TriangleCount(0)
+			, Radius(0.0)
+			, ConeCutoff(1.0)
+		{
+		}
+
+		/// The offset of first vertex in meshlet vertex array.
+		unsigned int VertexOffset;
+
+		/// The number of vertices.
+		unsigned int VertexCount;
+
+		/// The offset of first triangle in meshlet triangle array.
+		unsigned int TriangleOffset;
+
+		/// The number of triangles.
+		unsigned int TriangleCount;
+
+		/// The bounding sphere center.
+		Math::Vec3 Center;
+
+		/// The bounding sphere radius.
+		double Radius;
+
+		/// The apex of normal cone.
+		Math::Vec3 ConeApex;
+
+		/// The axis of normal cone.
+		Math::Vec3 ConeAxis;
+
+		/// The sine of normal cone spread, 1 when cone cannot be culled.
+		///
+		/// @remarks
+		///		Meshlet is back-facing when dot(normalize(ConeApex - camera), ConeAxis) >= ConeCutoff.
+		double ConeCutoff;
+	};
+
+	/// Describes meshlets of mesh.
+	struct MeshletSet
+	{
+	public:
+		/// Vertex positions.
+		std::vector<Math::Vec3> Positions;
+
+		/// Meshlets.
+		std::vector<Meshlet> Meshlets;
+
+		/// Position indices of meshlet vertices.
+		std::vector<unsigned int> Vertices;
+
+		/// Meshlet vertex indices, relative to meshlet, three per triangle.
+		std::vector<unsigned char> Triangles;
+	};
+
+	/// Implements partitioning of mesh into meshlets.
+	///
+	/// @remarks
+	///		Meshlets are grown greedily from first unassigned triangle in
+	///		mesh order. Next triangle is chosen among triangles sharing vertex
+	///		with meshlet, preferring fewest new vertices, then triangle closest
+	///		to meshlet center. Triangle order of vertex cache optimized mesh
+	///		gives compact seeds.
+	class MeshletBuilder
+	{
+	public:
+		/// Creates instance of the MeshletBuilder class.
+		///
+		/// @param[in] maxVertices
+		///		The maximum number of vertices in meshlet, at most 256.
+		/// @param[in] maxTriangles
+		///		The maximum number of triangles in meshlet.
+		MeshletBuilder(unsigned int maxVertices, unsigned int maxTriangles);
+
+		/// Gets maximum number of vertices in meshlet.
+		///
+		/// @return
+		///		The number of vertices.
+		unsigned int GetMaxVertices() const { return m_MaxVertices; }
+
+		/// Gets maximum number of triangles in meshlet.
+		///
+		/// @return
+		///		The number of triangles.
+		unsigned int GetMaxTriangles() const { return m_MaxTriangles; }
+
+		/// Partitions mesh into meshlets.
+		///
+		/// @param[in] mesh
+		///		The mesh.
+		/// @param[out] result
+		///		The meshlets.
+		/// @param[in] listener
+		///		The progress listener.
+		void Build(const Mesh& mesh, MeshletSet& result, IProgressListener* listener) const;
+
+	private:
+		/// Computes bounding sphere and normal cone of meshlet.
+		///
+		/// @param[in] set
+		///		The meshlets.
+		/// @param[in,out] meshlet
+		///		The meshlet.
+		static void ComputeBounds(const MeshletSet& set, Meshlet& meshlet);
+
+		/// The maximum number of vertices.
+		unsigned int m_MaxVertices;
+
+		/// The maximum number of triangles.
+		unsigned int m_MaxTriangles;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_MeshletBuilder_H__ */
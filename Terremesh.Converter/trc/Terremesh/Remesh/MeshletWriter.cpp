@@ -0,0 +1,62 @@
+#include "MeshletWriter.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	MeshletWriter::MeshletWriter(std::ofstream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	void MeshletWriter::WriteVector(const Math::Vec3& value)
+	{
+		WriteValue((float)value.X);
+		WriteValue((float)value.Y);
+		WriteValue((float)value.Z);
+	}
+
+	bool MeshletWriter::Write(const MeshletSet& set, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Write meshlets");
+		}
+
+		m_Stream.write("TML1", 4);
+		WriteValue((unsigned int)set.Positions.size());
+		WriteValue((unsigned int)set.Meshlets.size());
+		WriteValue((unsigned int)set.Vertices.size());
+		WriteValue((unsigned int)(set.Triangles.size() / 3));
+
+		for (auto it = set.Positions.begin(); it != set.Positions.end(); ++it)
+		{
+			WriteVector(*it);
+		}
+
+		for (auto it = set.Meshlets.begin(); it != set.Meshlets.end(); ++it)
+		{
+			WriteValue(it->VertexOffset);
+			WriteValue(it->VertexCount);
+			WriteValue(it->TriangleOffset);
+			WriteValue(it->TriangleCount);
+			WriteVector(it->Center);
+			WriteValue((float)it->Radius);
+			WriteVector(it->ConeApex);
+			WriteVector(it->ConeAxis);
+			WriteValue((float)it->ConeCutoff);
+		}
+
+		m_Stream.write(reinterpret_cast<const char*>(set.Vertices.data()), set.Vertices.size() * sizeof(unsigned int));
+		m_Stream.write(reinterpret_cast<const char*>(set.Triangles.data()), set.Triangles.size());
+		m_Stream.flush();
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Write meshlets");
+		}
+
+		return m_Stream.good();
+	}
+}
+}
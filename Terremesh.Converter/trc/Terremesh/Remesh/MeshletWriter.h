@@ -0,0 +1,74 @@
+#pragma once
+#ifndef _Terremesh_Remesh_MeshletWriter_H__
+#define _Terremesh_Remesh_MeshletWriter_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "MeshletBuilder.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements binary meshlet writer.
+	///
+	/// @remarks
+	///		All values are little endian:
+	///
+	///			char[4]   "TML1"
+	///			uint32    vertex count
+	///			uint32    meshlet count
+	///			uint32    meshlet vertex count
+	///			uint32    meshlet triangle count
+	///			float[3]  vertex positions
+	///			meshlets:
+	///				uint32    vertex offset
+	///				uint32    vertex count
+	///				uint32    triangle offset
+	///				uint32    triangle count
+	///				float[4]  bounding sphere center and radius
+	///				float[3]  normal cone apex
+	///				float[3]  normal cone axis
+	///				float     normal cone cutoff
+	///			uint32    meshlet vertex position indices
+	///			uint8[3]  meshlet triangle vertex indices, relative to meshlet
+	class MeshletWriter
+	{
+	public:
+		/// Creates instance of the MeshletWriter class.
+		///
+		/// @param[in] stream
+		///		The binary output stream.
+		MeshletWriter(std::ofstream& stream);
+
+		/// Writes meshlets into stream.
+		///
+		/// @param[in] set
+		///		The meshlets.
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false when stream cannot be written.
+		bool Write(const MeshletSet& set, IProgressListener* listener);
+
+	private:
+		MeshletWriter(const MeshletWriter&);
+		MeshletWriter& operator = (const MeshletWriter&);
+
+		/// Writes raw value into stream.
+		template <typename T>
+		void WriteValue(const T& value)
+		{
+			m_Stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		/// Writes vector as single precision values.
+		void WriteVector(const Math::Vec3& value);
+
+		std::ofstream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_MeshletWriter_H__ */
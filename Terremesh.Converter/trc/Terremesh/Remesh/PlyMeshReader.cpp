@@ -0,0 +1,325 @@
+#include "PlyMeshReader.h"
+
+#include <cstring>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	PlyMeshReader::PlyMeshReader(std::istream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	PlyMeshReader::Type PlyMeshReader::ParseType(const std::string& name)
+	{
+		if ((name == "char") || (name == "int8")) return Type_Int8;
+		if ((name == "uchar") || (name == "uint8")) return Type_UInt8;
+		if ((name == "short") || (name == "int16")) return Type_Int16;
+		if ((name == "ushort") || (name == "uint16")) return Type_UInt16;
+		if ((name == "int") || (name == "int32")) return Type_Int32;
+		if ((name == "uint") || (name == "uint32")) return Type_UInt32;
+		if ((name == "float") || (name == "float32")) return Type_Float32;
+		if ((name == "double") || (name == "float64")) return Type_Float64;
+
+		return Type_Invalid;
+	}
+
+	size_t PlyMeshReader::GetTypeSize(Type type)
+	{
+		switch (type)
+		{
+		case Type_Int8:
+		case Type_UInt8:
+			return 1;
+		case Type_Int16:
+		case Type_UInt16:
+			return 2;
+		case Type_Int32:
+		case Type_UInt32:
+		case Type_Float32:
+			return 4;
+		case Type_Float64:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	double PlyMeshReader::DecodeValue(const unsigned char* data, Type type, bool swap)
+	{
+		unsigned char bytes[8];
+		size_t size = GetTypeSize(type);
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			bytes[i] = data[swap ? size - 1 - i : i];
+		}
+
+		switch (type)
+		{
+		case Type_Int8: { signed char value; memcpy(&value, bytes, 1); return value; }
+		case Type_UInt8: { unsigned char value; memcpy(&value, bytes, 1); return value; }
+		case Type_Int16: { short value; memcpy(&value, bytes, 2); return value; }
+		case Type_UInt16: { unsigned short value; memcpy(&value, bytes, 2); return value; }
+		case Type_Int32: { int value; memcpy(&value, bytes, 4); return value; }
+		case Type_UInt32: { unsigned int value; memcpy(&value, bytes, 4); return value; }
+		case Type_Float32: { float value; memcpy(&value, bytes, 4); return value; }
+		case Type_Float64: { double value; memcpy(&value, bytes, 8); return value; }
+		default: return 0.0;
+		}
+	}
+
+	bool PlyMeshReader::Read(Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Read PLY");
+		}
+
+		mesh.Clear();
+
+		// Header lines up to end_header
+		std::vector<Element> elements;
+		std::string line;
+		bool valid = std::getline(m_Stream, line) && (line.compare(0, 3, "ply") == 0);
+		bool binary = false;
+		bool swap = false;
+
+		while (valid && std::getline(m_Stream, line))
+		{
+			if (!line.empty() && (line[line.size() - 1] == '\r'))
+			{
+				line.erase(line.size() - 1);
+			}
+
+			std::istringstream words(line);
+			std::string keyword;
+			words >> keyword;
+
+			if (keyword == "end_header")
+			{
+				break;
+			}
+			else if (keyword == "format")
+			{
+				std::string format;
+				words >> format;
+
+				binary = (format == "binary_little_endian") || (format == "binary_big_endian");
+				swap = (format == "binary_big_endian");
+
+				if (!binary)
+				{
+					std::cerr << "Unsupported PLY format " << format << std::endl;
+					valid = false;
+				}
+			}
+			else if (keyword == "element")
+			{
+				Element element;
+				words >> element.Name >> element.Count;
+				elements.push_back(element);
+				valid = !words.fail();
+			}
+			else if (keyword == "property")
+			{
+				Property property;
+				std::string type;
+				words >> type;
+
+				if (type == "list")
+				{
+					std::string countType;
+					words >> countType >> type;
+					property.CountType = ParseType(countType);
+					valid = (property.CountType != Type_Invalid) && (property.CountType != Type_Float32) && (property.CountType != Type_Float64);
+				}
+				else
+				{
+					property.CountType = Type_Invalid;
+				}
+
+				words >> property.Name;
+				property.ValueType = ParseType(type);
+				valid = valid && !words.fail() && !elements.empty() && (property.ValueType != Type_Invalid);
+
+				if (valid)
+				{
+					elements.back().Properties.push_back(property);
+				}
+			}
+		}
+
+		valid = valid && binary && !m_Stream.fail();
+
+		// Body is read at once
+		std::vector<unsigned char> data;
+		char buffer[1 << 16];
+
+		while (valid && (m_Stream.read(buffer, sizeof(buffer)) || (m_Stream.gcount() > 0)))
+		{
+			data.insert(data.end(), buffer, buffer + m_Stream.gcount());
+		}
+
+		const unsigned char* cursor = data.data();
+		const unsigned char* end = data.data() + data.size();
+
+		std::vector<Math::Vec3> positions;
+		Mesh::TriangleContainer triangles;
+		std::vector<size_t> polygon;
+		size_t vertexCount = 0;
+
+		for (auto element = elements.begin(); element != elements.end(); ++element)
+		{
+			if (element->Name == "vertex")
+			{
+				vertexCount = element->Count;
+			}
+		}
+
+		for (auto element = elements.begin(); valid && (element != elements.end()); ++element)
+		{
+			bool isVertex = (element->Name == "vertex");
+			bool isFace = (element->Name == "face");
+			int coordinates[3] = { -1, -1, -1 };
+			int indices = -1;
+
+			for (size_t p = 0; p < element->Properties.size(); ++p)
+			{
+				auto& property = element->Properties[p];
+				bool scalar = (property.CountType == Type_Invalid);
+
+				if (isVertex && scalar && (property.Name.size() == 1) && (property.Name[0] >= 'x') && (property.Name[0] <= 'z'))
+				{
+					coordinates[property.Name[0] - 'x'] = (int)p;
+				}
+				else if (isFace && !scalar && ((property.Name == "vertex_indices") || (property.Name == "vertex_index")))
+				{
+					indices = (int)p;
+				}
+			}
+
+			if (isVertex)
+			{
+				// Each item takes at least one byte
+				valid = (coordinates[0] >= 0) && (coordinates[1] >= 0) && (coordinates[2] >= 0) && (element->Count <= (size_t)(end - cursor));
+
+				if (valid)
+				{
+					positions.resize(vertexCount);
+				}
+			}
+
+			for (size_t i = 0; valid && (i < element->Count); ++i)
+			{
+				if ((listener != nullptr) && ((i & 0xFFFF) == 0))
+				{
+					listener->OnStep((int)((cursor - data.data()) * 100 / std::max(data.size(), (size_t)1)), 100);
+				}
+
+				for (size_t p = 0; valid && (p < element->Properties.size()); ++p)
+				{
+					auto& property = element->Properties[p];
+					size_t valueSize = GetTypeSize(property.ValueType);
+
+					if (property.CountType == Type_Invalid)
+					{
+						if ((size_t)(end - cursor) < valueSize)
+						{
+							valid = false;
+							break;
+						}
+
+						if (isVertex)
+						{
+							double* targets[3] = { &positions[i].X, &positions[i].Y, &positions[i].Z };
+
+							for (auto j = 0; j < 3; ++j)
+							{
+								if (coordinates[j] == (int)p)
+								{
+									*targets[j] = DecodeValue(cursor, property.ValueType, swap);
+								}
+							}
+						}
+
+						cursor += valueSize;
+						continue;
+					}
+
+					size_t countSize = GetTypeSize(property.CountType);
+
+					if ((size_t)(end - cursor) < countSize)
+					{
+						valid = false;
+						break;
+					}
+
+					double count = DecodeValue(cursor, property.CountType, swap);
+					cursor += countSize;
+
+					if ((count < 0.0) || ((size_t)count > (size_t)(end - cursor) / valueSize))
+					{
+						valid = false;
+						break;
+					}
+
+					if (indices == (int)p)
+					{
+						polygon.clear();
+
+						for (size_t k = 0; k < (size_t)count; ++k)
+						{
+							double index = DecodeValue(cursor + k * valueSize, property.ValueType, swap);
+
+							if ((index < 0.0) || (index >= (double)vertexCount))
+							{
+								valid = false;
+								break;
+							}
+
+							polygon.push_back((size_t)index);
+						}
+
+						// Polygon is split into fan around its first vertex
+						for (size_t k = 2; valid && (k < polygon.size()); ++k)
+						{
+							triangles.push_back(Triangle(
+								(VertexId)polygon[0] + 1,
+								(VertexId)polygon[k - 1] + 1,
+								(VertexId)polygon[k] + 1));
+						}
+					}
+
+					cursor += (size_t)count * valueSize;
+				}
+			}
+		}
+
+		if (valid)
+		{
+			Mesh::VertexContainer vertices;
+
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				vertices.insert(vertices.end(), std::make_pair((VertexId)i + 1, Vertex(positions[i])));
+			}
+
+			mesh.SetVertices(vertices);
+			mesh.SetTriangles(triangles);
+		}
+		else
+		{
+			std::cerr << "Invalid PLY mesh" << std::endl;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Read PLY");
+		}
+
+		return valid;
+	}
+}
+}
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef _Terremesh_Remesh_PlyMeshReader_H__
+#define _Terremesh_Remesh_PlyMeshReader_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements binary .ply mesh reader.
+	///
+	/// @remarks
+	///		Both little and big endian binary formats are read. Body is loaded
+	///		into memory at once and walked element by element. Vertices take
+	///		x, y and z properties of "vertex" element and get IDs in order of
+	///		storage. Polygons of "face" element are split into triangle fans.
+	///		Other elements and properties are skipped.
+	class PlyMeshReader
+	{
+	public:
+		/// Creates instance of the PlyMeshReader class.
+		///
+		/// @param[in] stream
+		///		The binary input stream.
+		PlyMeshReader(std::istream& stream);
+
+		/// Reads mesh from stream.
+		///
+		/// @param[out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Read(Mesh& mesh, IProgressListener* listener);
+
+	private:
+		PlyMeshReader(const PlyMeshReader&);
+		PlyMeshReader& operator = (const PlyMeshReader&);
+
+		/// Specifies property value type.
+		enum Type
+		{
+			Type_Invalid,
+			Type_Int8,
+			Type_UInt8,
+			Type_Int16,
+			Type_UInt16,
+			Type_Int32,
+			Type_UInt32,
+			Type_Float32,
+			Type_Float64,
+		};
+
+		/// Describes element property.
+		struct Property
+		{
+			/// The property name.
+			std::string Name;
+
+			/// The value type.
+			Type ValueType;
+
+			/// The type of list size, Type_Invalid for scalar property.
+			Type CountType;
+		};
+
+		/// Describes element.
+		struct Element
+		{
+			/// The element name.
+			std::string Name;
+
+			/// The number of items.
+			size_t Count;
+
+			/// The properties of each item.
+			std::vector<Property> Properties;
+		};
+
+		/// Parses type name.
+		static Type ParseType(const std::string& name);
+
+		/// Gets size of type in bytes.
+		static size_t GetTypeSize(Type type);
+
+		/// Decodes value of type.
+		///
+		/// @param[in] data
+		///		The value bytes.
+		/// @param[in] type
+		///		The value type.
+		/// @param[in] swap
+		///		The value indicating whether bytes are in reversed order.
+		///
+		/// @return
+		///		The value.
+		static double DecodeValue(const unsigned char* data, Type type, bool swap);
+
+		std::istream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_PlyMeshReader_H__ */
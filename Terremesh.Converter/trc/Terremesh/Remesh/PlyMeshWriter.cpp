@@ -0,0 +1,84 @@
+#include "PlyMeshWriter.h"
+
+#include <cstring>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	PlyMeshWriter::PlyMeshWriter(std::ostream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	void PlyMeshWriter::Write(const Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Write PLY");
+		}
+
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		std::ostringstream header;
+		header << "ply\n"
+			<< "format binary_little_endian 1.0\n"
+			<< "element vertex " << vertices.size() << "\n"
+			<< "property float x\n"
+			<< "property float y\n"
+			<< "property float z\n"
+			<< "element face " << triangles.size() << "\n"
+			<< "property list uchar int vertex_indices\n"
+			<< "end_header\n";
+
+		// Values are stored in host order, little endian on supported platforms
+		const size_t vertexSize = 3 * sizeof(float);
+		const size_t faceSize = 1 + 3 * sizeof(int);
+		std::vector<char> body(vertices.size() * vertexSize + triangles.size() * faceSize);
+		std::map<VertexId, int> dense;
+		char* cursor = body.data();
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			float position[3] = { (float)it->second.Position.X, (float)it->second.Position.Y, (float)it->second.Position.Z };
+
+			dense.insert(dense.end(), std::make_pair(it->first, (int)dense.size()));
+			memcpy(cursor, position, vertexSize);
+			cursor += vertexSize;
+		}
+
+		size_t done = 0;
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it, ++done)
+		{
+			if ((listener != nullptr) && ((done & 0xFFFF) == 0))
+			{
+				listener->OnStep((int)(done * 100 / triangles.size()), 100);
+			}
+
+			int indices[3];
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				auto vertex = dense.find(it->Vertices[j]);
+				indices[j] = (vertex != dense.end()) ? vertex->second : 0;
+			}
+
+			*cursor++ = 3;
+			memcpy(cursor, indices, sizeof(indices));
+			cursor += sizeof(indices);
+		}
+
+		auto text = header.str();
+		m_Stream.write(text.data(), text.size());
+		m_Stream.write(body.data(), body.size());
+		m_Stream.flush();
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Write PLY");
+		}
+	}
+}
+}
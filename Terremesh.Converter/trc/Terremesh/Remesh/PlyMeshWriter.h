@@ -0,0 +1,45 @@
+#pragma once
+#ifndef _Terremesh_Remesh_PlyMeshWriter_H__
+#define _Terremesh_Remesh_PlyMeshWriter_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements binary .ply mesh writer.
+	///
+	/// @remarks
+	///		Mesh is written in binary_little_endian format with float x, y and
+	///		z vertex properties and uchar counted int vertex_indices face
+	///		property. Body is assembled in memory and written at once.
+	class PlyMeshWriter
+	{
+	public:
+		/// Creates instance of the PlyMeshWriter class.
+		///
+		/// @param[in] stream
+		///		The binary output stream.
+		PlyMeshWriter(std::ostream& stream);
+
+		/// Writes mesh into stream.
+		///
+		/// @param[in] mesh
+		///		The mesh to write.
+		/// @param[in] listener
+		///		The progress listener.
+		void Write(const Mesh& mesh, IProgressListener* listener);
+
+	private:
+		PlyMeshWriter(const PlyMeshWriter&);
+		PlyMeshWriter& operator = (const PlyMeshWriter&);
+
+		std::ostream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_PlyMeshWriter_H__ */
@@ -0,0 +1,138 @@
+#include "ProgressiveMeshWriter.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	ProgressiveMeshWriter::ProgressiveMeshWriter(std::ofstream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	void ProgressiveMeshWriter::OnCollapse(const EdgeCollapse& collapse)
+	{
+		m_Collapses.push_back(collapse);
+	}
+
+	void ProgressiveMeshWriter::WriteVector(const Math::Vec3& value)
+	{
+		WriteValue((float)value.X);
+		WriteValue((float)value.Y);
+		WriteValue((float)value.Z);
+	}
+
+	bool ProgressiveMeshWriter::Write(const Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Write progressive mesh");
+		}
+
+		// Replay collapses on input mesh, remembering positions restored by splits
+		CollapseReplayer replayer(mesh);
+
+		std::vector<std::pair<Math::Vec3, Math::Vec3> > positions;
+		positions.reserve(m_Collapses.size());
+
+		for (auto it = m_Collapses.begin(); it != m_Collapses.end(); ++it)
+		{
+			auto& current = replayer.GetVertices();
+
+			positions.push_back(std::make_pair(
+				current.find(it->Kept)->second.Position,
+				current.find(it->Removed)->second.Position));
+
+			replayer.Apply(*it);
+		}
+
+		auto& vertices = replayer.GetVertices();
+		auto& triangles = replayer.GetTriangles();
+
+		// Number base mesh vertices and triangles
+		std::map<VertexId, unsigned int> vertexIndices;
+		std::vector<unsigned int> triangleIndices(triangles.size(), 0);
+
+		unsigned int vertexCount = 0;
+		unsigned int triangleCount = 0;
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			vertexIndices.insert(std::make_pair(it->first, vertexCount++));
+		}
+
+		for (size_t i = 0; i < triangles.size(); ++i)
+		{
+			if (replayer.IsAlive(i))
+			{
+				triangleIndices[i] = triangleCount++;
+			}
+		}
+
+		m_Stream.write("TPM1", 4);
+		WriteValue(vertexCount);
+		WriteValue(triangleCount);
+		WriteValue((unsigned int)m_Collapses.size());
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			WriteVector(it->second.Position);
+		}
+
+		for (size_t i = 0; i < triangles.size(); ++i)
+		{
+			if (replayer.IsAlive(i))
+			{
+				for (auto j = 0; j < 3; ++j)
+				{
+					WriteValue(vertexIndices[triangles[i].Vertices[j]]);
+				}
+			}
+		}
+
+		// Vertex splits undo collapses in reverse order
+		int total = (int)m_Collapses.size();
+
+		for (int i = total - 1; i >= 0; --i)
+		{
+			if (listener != nullptr)
+			{
+				listener->OnStep(total - i, total);
+			}
+
+			const EdgeCollapse& collapse = m_Collapses[i];
+
+			vertexIndices[collapse.Removed] = vertexCount++;
+
+			WriteValue(vertexIndices[collapse.Kept]);
+			WriteVector(positions[i].first);
+			WriteVector(positions[i].second);
+			WriteValue((unsigned int)collapse.ChangedTriangles.size());
+			WriteValue((unsigned int)collapse.RemovedTriangles.size());
+
+			for (auto id = collapse.ChangedTriangles.begin(); id != collapse.ChangedTriangles.end(); ++id)
+			{
+				WriteValue(triangleIndices[*id]);
+			}
+
+			for (auto id = collapse.RemovedTriangles.begin(); id != collapse.RemovedTriangles.end(); ++id)
+			{
+				triangleIndices[*id] = triangleCount++;
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					WriteValue(vertexIndices[triangles[*id].Vertices[j]]);
+				}
+			}
+		}
+
+		m_Stream.flush();
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Write progressive mesh");
+		}
+
+		return m_Stream.good();
+	}
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef _Terremesh_Remesh_ProgressiveMeshWriter_H__
+#define _Terremesh_Remesh_ProgressiveMeshWriter_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "../ICollapseListener.h"
+#include "Mesh.h"
+#include "EdgeCollapse.h"
+#include "CollapseReplayer.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements progressive mesh writer.
+	///
+	/// @remarks
+	///		Writer records collapses performed by remeshing method and writes
+	///		base mesh followed by vertex splits which undo them in reverse
+	///		order. Any prefix of vertex splits gives valid mesh. All values
+	///		are little endian:
+	///
+	///			char[4]   "TPM1"
+	///			uint32    base vertex count
+	///			uint32    base triangle count
+	///			uint32    vertex split count
+	///			float[3]  base vertex positions
+	///			uint32[3] base triangle vertex indices
+	///			vertex splits:
+	///				uint32    kept vertex index
+	///				float[3]  kept vertex position
+	///				float[3]  new vertex position
+	///				uint32    changed triangle count
+	///				uint32    restored triangle count
+	///				uint32    changed triangle indices
+	///				uint32[3] restored triangle vertex indices
+	///
+	///		Each split appends new vertex and restored triangles to the end
+	///		of vertex and triangle arrays, and replaces kept vertex by new
+	///		vertex in changed triangles.
+	class ProgressiveMeshWriter
+		: public ICollapseListener
+	{
+	public:
+		/// Creates instance of the ProgressiveMeshWriter class.
+		///
+		/// @param[in] stream
+		///		The binary output stream.
+		ProgressiveMeshWriter(std::ofstream& stream);
+
+		virtual void OnCollapse(const EdgeCollapse& collapse);
+
+		/// Writes progressive mesh into stream.
+		///
+		/// @param[in] mesh
+		///		The input mesh, on which recorded collapses were performed.
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false when stream cannot be written.
+		bool Write(const Mesh& mesh, IProgressListener* listener);
+
+	private:
+		ProgressiveMeshWriter(const ProgressiveMeshWriter&);
+		ProgressiveMeshWriter& operator = (const ProgressiveMeshWriter&);
+
+		/// Writes raw value into stream.
+		template <typename T>
+		void WriteValue(const T& value)
+		{
+			m_Stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		/// Writes vector as single precision values.
+		void WriteVector(const Math::Vec3& value);
+
+		std::ofstream& m_Stream;
+
+		/// Recorded collapses.
+		std::vector<EdgeCollapse> m_Collapses;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_ProgressiveMeshWriter_H__ */
@@ -0,0 +1,147 @@
+#include "StlMeshReader.h"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// The size of binary STL header, including triangle count.
+	static const size_t HeaderSize = 84;
+
+	/// The size of binary STL triangle record.
+	static const size_t RecordSize = 50;
+
+	/// Describes exact corner position.
+	struct StlCorner
+	{
+		/// The bits of coordinates.
+		unsigned int Bits[3];
+
+		bool operator == (const StlCorner& corner) const
+		{
+			return (Bits[0] == corner.Bits[0]) && (Bits[1] == corner.Bits[1]) && (Bits[2] == corner.Bits[2]);
+		}
+	};
+
+	/// Computes hash of corner position.
+	struct StlCornerHash
+	{
+		size_t operator () (const StlCorner& corner) const
+		{
+			unsigned long long hash = 14695981039346656037ULL;
+
+			for (auto i = 0; i < 3; ++i)
+			{
+				hash = (hash ^ corner.Bits[i]) * 1099511628211ULL;
+			}
+
+			return (size_t)(hash ^ (hash >> 32));
+		}
+	};
+
+	StlMeshReader::StlMeshReader(std::istream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	bool StlMeshReader::Read(Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Read STL");
+		}
+
+		mesh.Clear();
+
+		std::vector<char> data;
+		char buffer[1 << 16];
+
+		while (m_Stream.read(buffer, sizeof(buffer)) || (m_Stream.gcount() > 0))
+		{
+			data.insert(data.end(), buffer, buffer + m_Stream.gcount());
+		}
+
+		unsigned int count = 0;
+
+		if (data.size() >= HeaderSize)
+		{
+			memcpy(&count, data.data() + HeaderSize - sizeof(count), sizeof(count));
+		}
+
+		bool valid = (data.size() >= HeaderSize) && (count <= (data.size() - HeaderSize) / RecordSize);
+
+		if (valid)
+		{
+			std::unordered_map<StlCorner, VertexId, StlCornerHash> welded;
+			std::vector<Math::Vec3> positions;
+			Mesh::TriangleContainer triangles;
+
+			welded.reserve(count);
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				if ((listener != nullptr) && ((i & 0xFFFF) == 0))
+				{
+					listener->OnStep((int)((unsigned long long)i * 100 / count), 100);
+				}
+
+				// Record holds normal, three corners and attribute
+				const char* record = data.data() + HeaderSize + (size_t)i * RecordSize;
+				VertexId ids[3];
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					float position[3];
+					StlCorner corner;
+
+					memcpy(position, record + (j + 1) * sizeof(position), sizeof(position));
+
+					for (auto k = 0; k < 3; ++k)
+					{
+						// Both zeros weld together
+						position[k] = (position[k] == 0.0f) ? 0.0f : position[k];
+						memcpy(&corner.Bits[k], &position[k], sizeof(float));
+					}
+
+					auto inserted = welded.insert(std::make_pair(corner, (VertexId)positions.size() + 1));
+
+					if (inserted.second)
+					{
+						positions.push_back(Math::Vec3(position[0], position[1], position[2]));
+					}
+
+					ids[j] = inserted.first->second;
+				}
+
+				if ((ids[0] != ids[1]) && (ids[1] != ids[2]) && (ids[2] != ids[0]))
+				{
+					triangles.push_back(Triangle(ids[0], ids[1], ids[2]));
+				}
+			}
+
+			Mesh::VertexContainer vertices;
+
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				vertices.insert(vertices.end(), std::make_pair((VertexId)i + 1, Vertex(positions[i])));
+			}
+
+			mesh.SetVertices(vertices);
+			mesh.SetTriangles(triangles);
+		}
+		else
+		{
+			std::cerr << "Invalid STL mesh" << std::endl;
+		}
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Read STL");
+		}
+
+		return valid;
+	}
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef _Terremesh_Remesh_StlMeshReader_H__
+#define _Terremesh_Remesh_StlMeshReader_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements binary .stl mesh reader.
+	///
+	/// @remarks
+	///		Binary STL stores three corners per triangle with no sharing.
+	///		Corners are welded through hash table keyed by exact float
+	///		position, vertices get IDs in order of first appearance.
+	///		Triangles whose corners weld together are dropped.
+	class StlMeshReader
+	{
+	public:
+		/// Creates instance of the StlMeshReader class.
+		///
+		/// @param[in] stream
+		///		The binary input stream.
+		StlMeshReader(std::istream& stream);
+
+		/// Reads mesh from stream.
+		///
+		/// @param[out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool Read(Mesh& mesh, IProgressListener* listener);
+
+	private:
+		StlMeshReader(const StlMeshReader&);
+		StlMeshReader& operator = (const StlMeshReader&);
+
+		std::istream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_StlMeshReader_H__ */
@@ -0,0 +1,88 @@
+#include "StlMeshWriter.h"
+
+#include <cstring>
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	StlMeshWriter::StlMeshWriter(std::ostream& stream)
+		: m_Stream(stream)
+	{
+	}
+
+	void StlMeshWriter::Write(const Mesh& mesh, IProgressListener* listener)
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Write STL");
+		}
+
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		// Header text is padded by zeros, count follows
+		const size_t recordSize = 50;
+		std::vector<char> data(84 + triangles.size() * recordSize, 0);
+		const char title[] = "Terremesh binary STL";
+		unsigned int count = (unsigned int)triangles.size();
+
+		memcpy(data.data(), title, sizeof(title) - 1);
+		memcpy(data.data() + 80, &count, sizeof(count));
+
+		char* cursor = data.data() + 84;
+		size_t done = 0;
+		Math::Vec3 origin(0.0, 0.0, 0.0);
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it, ++done)
+		{
+			if ((listener != nullptr) && ((done & 0xFFFF) == 0))
+			{
+				listener->OnStep((int)(done * 100 / triangles.size()), 100);
+			}
+
+			const Math::Vec3* corners[3];
+
+			for (auto j = 0; j < 3; ++j)
+			{
+				auto vertex = vertices.find(it->Vertices[j]);
+				corners[j] = (vertex != vertices.end()) ? &vertex->second.Position : &origin;
+			}
+
+			Math::Vec3 edge1;
+			Math::Vec3 edge2;
+			Math::Vec3::Subtract(edge1, *corners[1], *corners[0]);
+			Math::Vec3::Subtract(edge2, *corners[2], *corners[0]);
+
+			Math::Vec3 normal(
+				edge1.Y * edge2.Z - edge1.Z * edge2.Y,
+				edge1.Z * edge2.X - edge1.X * edge2.Z,
+				edge1.X * edge2.Y - edge1.Y * edge2.X);
+
+			if (normal.Length() > 0.0)
+			{
+				normal.Normalize();
+			}
+
+			float values[12] = {
+				(float)normal.X, (float)normal.Y, (float)normal.Z,
+				(float)corners[0]->X, (float)corners[0]->Y, (float)corners[0]->Z,
+				(float)corners[1]->X, (float)corners[1]->Y, (float)corners[1]->Z,
+				(float)corners[2]->X, (float)corners[2]->Y, (float)corners[2]->Z,
+			};
+
+			// Attribute byte count stays zero
+			memcpy(cursor, values, sizeof(values));
+			cursor += recordSize;
+		}
+
+		m_Stream.write(data.data(), data.size());
+		m_Stream.flush();
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Write STL");
+		}
+	}
+}
+}
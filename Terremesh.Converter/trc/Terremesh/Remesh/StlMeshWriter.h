@@ -0,0 +1,44 @@
+#pragma once
+#ifndef _Terremesh_Remesh_StlMeshWriter_H__
+#define _Terremesh_Remesh_StlMeshWriter_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Implements binary .stl mesh writer.
+	///
+	/// @remarks
+	///		Each triangle is written with its unit normal and float corners.
+	///		Records are assembled in memory and written at once.
+	class StlMeshWriter
+	{
+	public:
+		/// Creates instance of the StlMeshWriter class.
+		///
+		/// @param[in] stream
+		///		The binary output stream.
+		StlMeshWriter(std::ostream& stream);
+
+		/// Writes mesh into stream.
+		///
+		/// @param[in] mesh
+		///		The mesh to write.
+		/// @param[in] listener
+		///		The progress listener.
+		void Write(const Mesh& mesh, IProgressListener* listener);
+
+	private:
+		StlMeshWriter(const StlMeshWriter&);
+		StlMeshWriter& operator = (const StlMeshWriter&);
+
+		std::ostream& m_Stream;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_StlMeshWriter_H__ */
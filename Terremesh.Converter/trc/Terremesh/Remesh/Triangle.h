@@ -3,7 +3,6 @@
 #define _Terremesh_Remesh_Triangle_H__
 
 #include "Vertex.h"
-#include "../Math/Plane.h"
 
 namespace Terremesh
 {
@@ -40,14 +39,11 @@ namespace Remesh
 		///
 		/// @retval true when successful.
 		/// @retval false otherwise.
-		bool HasVertex(VertexId id)
+		bool HasVertex(VertexId id) const
 		{
 			return Vertices[0] == id || Vertices[1] == id || Vertices[2] == id;
 		}
 
-		/// Triangle plane.
-		Math::Plane Plane;
-
 		/// Vertices
 		VertexId Vertices[3];
 	};
@@ -32,7 +32,7 @@ namespace Remesh
 	};
 	
 	/// The vertex identifier.
-	typedef int VertexId;
+	typedef unsigned int VertexId;
 }
 }
 
@@ -0,0 +1,280 @@
+#include "VertexCacheOptimizer.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	VertexCacheOptimizer::VertexCacheOptimizer(unsigned int cacheSize)
+		: m_CacheSize(std::max(cacheSize, 3U))
+	{
+	}
+
+	void VertexCacheOptimizer::GetIndices(const Mesh& mesh, std::vector<unsigned int>& indices, std::vector<VertexId>& ids)
+	{
+		auto& vertices = mesh.GetVertices();
+		auto& triangles = mesh.GetTriangles();
+
+		std::map<VertexId, unsigned int> dense;
+
+		ids.clear();
+		ids.reserve(vertices.size());
+
+		for (auto it = vertices.begin(); it != vertices.end(); ++it)
+		{
+			dense.insert(dense.end(), std::make_pair(it->first, (unsigned int)ids.size()));
+			ids.push_back(it->first);
+		}
+
+		indices.clear();
+		indices.reserve(triangles.size() * 3);
+
+		for (auto it = triangles.begin(); it != triangles.end(); ++it)
+		{
+			for (auto j = 0; j < 3; ++j)
+			{
+				indices.push_back(dense.find(it->Vertices[j])->second);
+			}
+		}
+	}
+
+	void VertexCacheOptimizer::Optimize(Mesh& mesh, IProgressListener* listener) const
+	{
+		if (listener != nullptr)
+		{
+			listener->OnStarted("Optimize vertex cache");
+		}
+
+		std::vector<unsigned int> indices;
+		std::vector<VertexId> ids;
+
+		GetIndices(mesh, indices, ids);
+		OptimizeTriangles(indices, ids.size());
+
+		// Renumber vertices by first use, unused ones keep their order at the end
+		const unsigned int unused = ~0U;
+		std::vector<unsigned int> order(ids.size(), unused);
+		unsigned int next = 0;
+
+		for (auto it = indices.begin(); it != indices.end(); ++it)
+		{
+			if (order[*it] == unused)
+			{
+				order[*it] = next++;
+			}
+		}
+
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			if (order[i] == unused)
+			{
+				order[i] = next++;
+			}
+		}
+
+		auto& vertices = mesh.GetVertices();
+		std::vector<const Vertex*> reordered(ids.size(), nullptr);
+
+		for (size_t i = 0; i < ids.size(); ++i)
+		{
+			reordered[order[i]] = &vertices.find(ids[i])->second;
+		}
+
+		Mesh::VertexContainer renumbered;
+
+		for (size_t i = 0; i < reordered.size(); ++i)
+		{
+			renumbered.insert(renumbered.end(), std::make_pair((VertexId)i + 1, *reordered[i]));
+		}
+
+		Mesh::TriangleContainer triangles;
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			triangles.push_back(Triangle(
+				(VertexId)order[indices[i + 0]] + 1,
+				(VertexId)order[indices[i + 1]] + 1,
+				(VertexId)order[indices[i + 2]] + 1));
+		}
+
+		mesh.SetVertices(renumbered);
+		mesh.SetTriangles(triangles);
+
+		if (listener != nullptr)
+		{
+			listener->OnCompleted("Optimize vertex cache");
+		}
+	}
+
+	void VertexCacheOptimizer::OptimizeTriangles(std::vector<unsigned int>& indices, size_t vertexCount) const
+	{
+		size_t triangleCount = indices.size() / 3;
+
+		// Triangles adjacent to each vertex
+		std::vector<size_t> offsets(vertexCount + 1, 0);
+
+		for (auto it = indices.begin(); it != indices.end(); ++it)
+		{
+			++offsets[*it + 1];
+		}
+
+		for (size_t i = 1; i < offsets.size(); ++i)
+		{
+			offsets[i] += offsets[i - 1];
+		}
+
+		std::vector<size_t> adjacency(offsets.back());
+		std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			adjacency[fill[indices[i]]++] = i / 3;
+		}
+
+		// Number of not emitted triangles of each vertex
+		std::vector<unsigned int> live(vertexCount, 0);
+
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			live[i] = (unsigned int)(offsets[i + 1] - offsets[i]);
+		}
+
+		std::vector<size_t> timestamps(vertexCount, 0);
+		std::vector<char> emitted(triangleCount, 0);
+		std::vector<unsigned int> deadEnds;
+		std::vector<unsigned int> candidates;
+		std::vector<unsigned int> result;
+
+		result.reserve(indices.size());
+
+		size_t time = m_CacheSize + 1;
+		size_t cursor = 0;
+		long long fan = (vertexCount > 0) ? 0 : -1;
+
+		while (fan >= 0)
+		{
+			auto vertex = (size_t)fan;
+
+			candidates.clear();
+
+			// Emit all remaining triangles around fan vertex
+			for (size_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i)
+			{
+				auto triangle = adjacency[i];
+
+				if (emitted[triangle])
+				{
+					continue;
+				}
+
+				emitted[triangle] = 1;
+
+				for (auto j = 0; j < 3; ++j)
+				{
+					auto corner = indices[triangle * 3 + j];
+
+					result.push_back(corner);
+					deadEnds.push_back(corner);
+					candidates.push_back(corner);
+					--live[corner];
+
+					if (time - timestamps[corner] > m_CacheSize)
+					{
+						timestamps[corner] = time++;
+					}
+				}
+			}
+
+			// Prefer candidate that stays in cache while its fan is emitted
+			fan = -1;
+			size_t best = 0;
+
+			for (auto it = candidates.begin(); it != candidates.end(); ++it)
+			{
+				if (live[*it] == 0)
+				{
+					continue;
+				}
+
+				size_t priority = 0;
+
+				if (time - timestamps[*it] + 2 * live[*it] <= m_CacheSize)
+				{
+					priority = time - timestamps[*it];
+				}
+
+				if ((fan < 0) || (priority > best))
+				{
+					best = priority;
+					fan = *it;
+				}
+			}
+
+			// Dead end - resume with recently used vertex, then in vertex order
+			while ((fan < 0) && !deadEnds.empty())
+			{
+				auto last = deadEnds.back();
+				deadEnds.pop_back();
+
+				if (live[last] > 0)
+				{
+					fan = last;
+				}
+			}
+
+			while ((fan < 0) && (cursor < vertexCount))
+			{
+				if (live[cursor] > 0)
+				{
+					fan = (long long)cursor;
+				}
+
+				++cursor;
+			}
+		}
+
+		indices.swap(result);
+	}
+
+	VertexCacheStatistics VertexCacheOptimizer::Measure(const Mesh& mesh) const
+	{
+		std::vector<unsigned int> indices;
+		std::vector<VertexId> ids;
+
+		GetIndices(mesh, indices, ids);
+		return Measure(indices, ids.size());
+	}
+
+	VertexCacheStatistics VertexCacheOptimizer::Measure(const std::vector<unsigned int>& indices, size_t vertexCount) const
+	{
+		VertexCacheStatistics result;
+
+		// Vertex is cached while fewer than cache size misses followed its own
+		const size_t never = ~(size_t)0;
+		std::vector<size_t> inserted(vertexCount, never);
+		size_t misses = 0;
+		size_t used = 0;
+
+		for (auto it = indices.begin(); it != indices.end(); ++it)
+		{
+			if (inserted[*it] == never)
+			{
+				++used;
+			}
+			else if (misses - inserted[*it] < m_CacheSize)
+			{
+				continue;
+			}
+
+			inserted[*it] = misses++;
+		}
+
+		if (!indices.empty())
+		{
+			result.AverageCacheMissRatio = (double)misses / (double)(indices.size() / 3);
+			result.AverageTransformToVertexRatio = (double)misses / (double)used;
+		}
+
+		return result;
+	}
+}
+}
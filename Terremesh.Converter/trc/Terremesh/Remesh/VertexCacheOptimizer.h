@@ -0,0 +1,100 @@
+#pragma once
+#ifndef _Terremesh_Remesh_VertexCacheOptimizer_H__
+#define _Terremesh_Remesh_VertexCacheOptimizer_H__
+
+#include "../Required.h"
+#include "../IProgressListener.h"
+#include "Mesh.h"
+
+namespace Terremesh
+{
+namespace Remesh
+{
+	/// Describes efficiency of post-transform vertex cache.
+	struct VertexCacheStatistics
+	{
+	public:
+		/// Creates instance of the VertexCacheStatistics structure.
+		VertexCacheStatistics()
+			: AverageCacheMissRatio(0.0)
+			, AverageTransformToVertexRatio(0.0)
+		{
+		}
+
+		/// Transformed vertices per triangle (ACMR), 0.5 at best for large grids.
+		double AverageCacheMissRatio;
+
+		/// Transformed vertices per used vertex (ATVR), 1.0 at best.
+		double AverageTransformToVertexRatio;
+	};
+
+	/// Implements reordering of triangles and vertices for vertex cache locality.
+	///
+	/// @remarks
+	///		Triangles are ordered by Tipsify (Sander, Nehab, Barczak 2007):
+	///		fans around vertices are emitted in turn, next fan vertex is
+	///		chosen among vertices of recent triangles by its expected cache
+	///		position. Vertices are then renumbered by first use, so vertex
+	///		fetches walk memory forward. Geometry is unchanged.
+	class VertexCacheOptimizer
+	{
+	public:
+		/// Creates instance of the VertexCacheOptimizer class.
+		///
+		/// @param[in] cacheSize
+		///		The number of entries of simulated FIFO cache.
+		VertexCacheOptimizer(unsigned int cacheSize);
+
+		/// Gets number of entries of simulated FIFO cache.
+		///
+		/// @return
+		///		The cache size.
+		unsigned int GetCacheSize() const { return m_CacheSize; }
+
+		/// Reorders triangles and vertices of mesh.
+		///
+		/// @param[in,out] mesh
+		///		The mesh.
+		/// @param[in] listener
+		///		The progress listener.
+		void Optimize(Mesh& mesh, IProgressListener* listener) const;
+
+		/// Reorders triangles of index buffer, keeping vertex order.
+		///
+		/// @param[in,out] indices
+		///		The triangle vertex indices, three per triangle.
+		/// @param[in] vertexCount
+		///		The number of vertices.
+		void OptimizeTriangles(std::vector<unsigned int>& indices, size_t vertexCount) const;
+
+		/// Measures vertex cache efficiency of mesh.
+		///
+		/// @param[in] mesh
+		///		The mesh.
+		///
+		/// @return
+		///		The statistics.
+		VertexCacheStatistics Measure(const Mesh& mesh) const;
+
+		/// Measures vertex cache efficiency of index buffer.
+		///
+		/// @param[in] indices
+		///		The triangle vertex indices, three per triangle.
+		/// @param[in] vertexCount
+		///		The number of vertices.
+		///
+		/// @return
+		///		The statistics.
+		VertexCacheStatistics Measure(const std::vector<unsigned int>& indices, size_t vertexCount) const;
+
+	private:
+		/// Converts mesh triangles into dense index buffer.
+		static void GetIndices(const Mesh& mesh, std::vector<unsigned int>& indices, std::vector<VertexId>& ids);
+
+		/// The cache size.
+		unsigned int m_CacheSize;
+	};
+}
+}
+
+#endif /* _Terremesh_Remesh_VertexCacheOptimizer_H__ */
@@ -6,14 +6,25 @@
 #define _SECURE_SCL_THROWS 0
 
 #include <cmath>
+#include <cstdlib>
 #include <cassert>
 #include <ctime>
 
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <limits>
 #include <deque>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <functional>
+#include <memory>
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #endif /* _Terremesh_Required_H__ */
\ No newline at end of file
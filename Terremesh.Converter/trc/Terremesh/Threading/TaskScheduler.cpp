@@ -0,0 +1,274 @@
+#include "TaskScheduler.h"
+
+namespace Terremesh
+{
+namespace Threading
+{
+	TaskScheduler::TaskScheduler(int threads)
+		: m_Queued(0)
+		, m_Started(false)
+		, m_Stop(false)
+	{
+		if (threads <= 0)
+		{
+			threads = std::max(1, (int)std::thread::hardware_concurrency());
+		}
+
+		for (int i = 0; i < threads; ++i)
+		{
+			m_Queues.push_back(std::unique_ptr<Queue>(new Queue()));
+		}
+
+		for (int i = 0; i < threads - 1; ++i)
+		{
+			m_Threads.push_back(std::thread(&TaskScheduler::Work, this, (size_t)i));
+			m_ThreadIds.push_back(m_Threads.back().get_id());
+		}
+
+		// Workers wait until their identifiers are known
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Started = true;
+		}
+
+		m_SleepCondition.notify_all();
+	}
+
+	TaskScheduler::~TaskScheduler()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Stop = true;
+		}
+
+		m_SleepCondition.notify_all();
+
+		for (auto it = m_Threads.begin(); it != m_Threads.end(); ++it)
+		{
+			it->join();
+		}
+	}
+
+	void TaskScheduler::Run(TaskGroup& group, const Task& task)
+	{
+		Entry entry;
+		entry.Function = task;
+		entry.Group = &group;
+
+		Queue& queue = *m_Queues[GetQueueIndex()];
+
+		// Counted only once queued, so failed push leaves group consistent
+		{
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Entries.push_back(entry);
+			++group.m_Pending;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			++m_Queued;
+		}
+
+		m_SleepCondition.notify_one();
+	}
+
+	void TaskScheduler::Wait(TaskGroup& group)
+	{
+		size_t index = GetQueueIndex();
+
+		while (group.m_Pending != 0)
+		{
+			if (!TryRun(index, &group))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		if (group.m_Exception)
+		{
+			std::exception_ptr exception = group.m_Exception;
+			group.m_Exception = nullptr;
+
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void TaskScheduler::ParallelFor(size_t begin, size_t end, size_t grain, const RangeTask& task)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		grain = std::max(grain, (size_t)1);
+
+		// Few subranges per thread leave room for stealing
+		size_t count = end - begin;
+		size_t chunks = std::min((count + grain - 1) / grain, (size_t)GetThreadCount() * 4);
+
+		if (chunks <= 1)
+		{
+			task(begin, end);
+			return;
+		}
+
+		TaskGroup group;
+		size_t chunkSize = (count + chunks - 1) / chunks;
+
+		// Queued subranges reference task and group, so they are waited for even on failure
+		try
+		{
+			for (size_t first = begin + chunkSize; first < end; first += chunkSize)
+			{
+				size_t last = std::min(first + chunkSize, end);
+
+				Run(group, [&task, first, last]()
+				{
+					task(first, last);
+				});
+			}
+
+			task(begin, begin + chunkSize);
+		}
+		catch (...)
+		{
+			group.SetException(std::current_exception());
+		}
+
+		Wait(group);
+	}
+
+	size_t TaskScheduler::GetQueueIndex() const
+	{
+		auto id = std::this_thread::get_id();
+
+		for (size_t i = 0; i < m_ThreadIds.size(); ++i)
+		{
+			if (m_ThreadIds[i] == id)
+			{
+				return i;
+			}
+		}
+
+		// Other threads get their own queue, so they never push to LIFO end of worker queue
+		return m_Threads.size();
+	}
+
+	bool TaskScheduler::TryPop(Queue& queue, bool newest, TaskGroup* group, Entry& entry)
+	{
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+
+		if (queue.Entries.empty())
+		{
+			return false;
+		}
+
+		if (group == nullptr)
+		{
+			if (newest)
+			{
+				entry = queue.Entries.back();
+				queue.Entries.pop_back();
+			}
+			else
+			{
+				entry = queue.Entries.front();
+				queue.Entries.pop_front();
+			}
+
+			return true;
+		}
+
+		// Waiting thread runs only tasks of awaited group
+		if (newest)
+		{
+			for (auto it = queue.Entries.rbegin(); it != queue.Entries.rend(); ++it)
+			{
+				if (it->Group == group)
+				{
+					entry = *it;
+					queue.Entries.erase(std::next(it).base());
+					return true;
+				}
+			}
+		}
+		else
+		{
+			for (auto it = queue.Entries.begin(); it != queue.Entries.end(); ++it)
+			{
+				if (it->Group == group)
+				{
+					entry = *it;
+					queue.Entries.erase(it);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool TaskScheduler::TryRun(size_t index, TaskGroup* group)
+	{
+		Entry entry;
+		bool found = TryPop(*m_Queues[index], true, group, entry);
+
+		for (size_t i = 1; !found && (i < m_Queues.size()); ++i)
+		{
+			found = TryPop(*m_Queues[(index + i) % m_Queues.size()], false, group, entry);
+		}
+
+		if (!found)
+		{
+			return false;
+		}
+
+		--m_Queued;
+
+		try
+		{
+			entry.Function();
+		}
+		catch (...)
+		{
+			entry.Group->SetException(std::current_exception());
+		}
+
+		--entry.Group->m_Pending;
+
+		return true;
+	}
+
+	void TaskScheduler::Work(size_t index)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+
+			while (!m_Started)
+			{
+				m_SleepCondition.wait(lock);
+			}
+		}
+
+		for (;;)
+		{
+			if (TryRun(index, nullptr))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+
+			while (!m_Stop && (m_Queued == 0))
+			{
+				m_SleepCondition.wait(lock);
+			}
+
+			if (m_Stop)
+			{
+				break;
+			}
+		}
+	}
+}
+}
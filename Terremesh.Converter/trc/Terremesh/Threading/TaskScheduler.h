@@ -0,0 +1,219 @@
+#pragma once
+#ifndef _Terremesh_Threading_TaskScheduler_H__
+#define _Terremesh_Threading_TaskScheduler_H__
+
+#include "../Required.h"
+#include <exception>
+
+namespace Terremesh
+{
+namespace Threading
+{
+	/// Implements group of tasks which can be waited for.
+	///
+	/// @remarks
+	///		Exception thrown by task is stored in its group and rethrown by
+	///		Wait, so failure of parallel part reaches thread which started it.
+	class TaskGroup
+	{
+	public:
+		/// Creates instance of the TaskGroup class.
+		TaskGroup()
+			: m_Pending(0)
+		{
+		}
+
+		/// Determines whether all tasks of group are completed.
+		///
+		/// @retval true when successful.
+		/// @retval false otherwise.
+		bool IsCompleted() const { return m_Pending == 0; }
+
+	private:
+		friend class TaskScheduler;
+
+		TaskGroup(const TaskGroup&);
+		TaskGroup& operator = (const TaskGroup&);
+
+		/// Stores exception thrown by task, keeping the first one.
+		///
+		/// @param[in] exception
+		///		The exception.
+		void SetException(std::exception_ptr exception)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (!m_Exception)
+			{
+				m_Exception = exception;
+			}
+		}
+
+		/// The number of pending tasks.
+		std::atomic<int> m_Pending;
+
+		/// The mutex guarding exception.
+		std::mutex m_Mutex;
+
+		/// The first exception thrown by task of group.
+		std::exception_ptr m_Exception;
+	};
+
+	/// Implements work-stealing task scheduler.
+	///
+	/// @remarks
+	///		Each worker owns task queue, runs its newest tasks first and steals
+	///		oldest tasks of other workers when idle. Thread waiting for group
+	///		runs pending tasks of that group, so scheduler with N threads
+	///		creates N - 1 workers and waits may be nested freely.
+	class TaskScheduler
+	{
+	public:
+		/// The task type.
+		typedef std::function<void()> Task;
+
+		/// The range task type.
+		typedef std::function<void(size_t, size_t)> RangeTask;
+
+		/// Creates instance of the TaskScheduler class.
+		///
+		/// @param[in] threads
+		///		The number of threads, including waiting thread. Zero selects
+		///		hardware concurrency.
+		TaskScheduler(int threads);
+
+		/// Destroys instance of the TaskScheduler class.
+		~TaskScheduler();
+
+		/// Gets number of threads.
+		///
+		/// @return
+		///		The number of threads.
+		int GetThreadCount() const { return (int)m_Threads.size() + 1; }
+
+		/// Runs task asynchronously.
+		///
+		/// @param[in,out] group
+		///		The group of task.
+		/// @param[in] task
+		///		The task.
+		void Run(TaskGroup& group, const Task& task);
+
+		/// Waits for all tasks of group, running them meanwhile.
+		///
+		/// @param[in,out] group
+		///		The group.
+		///
+		/// @remarks
+		///		The first exception thrown by tasks of group is rethrown
+		///		after all of them completed.
+		void Wait(TaskGroup& group);
+
+		/// Runs task for subranges of range in parallel and waits for them.
+		///
+		/// @param[in] begin
+		///		The range begin.
+		/// @param[in] end
+		///		The range end.
+		/// @param[in] grain
+		///		The minimal size of subrange.
+		/// @param[in] task
+		///		The task receiving subrange begin and end.
+		///
+		/// @remarks
+		///		The first exception thrown by task is rethrown after all
+		///		subranges completed.
+		void ParallelFor(size_t begin, size_t end, size_t grain, const RangeTask& task);
+
+	private:
+		TaskScheduler(const TaskScheduler&);
+		TaskScheduler& operator = (const TaskScheduler&);
+
+		/// Describes queued task.
+		struct Entry
+		{
+			/// The task.
+			Task Function;
+
+			/// The group of task.
+			TaskGroup* Group;
+		};
+
+		/// Describes task queue.
+		struct Queue
+		{
+			/// The queue mutex.
+			std::mutex Mutex;
+
+			/// The queued tasks.
+			std::deque<Entry> Entries;
+		};
+
+		/// Gets queue of calling thread.
+		///
+		/// @return
+		///		The index of worker queue, or index of the last queue for
+		///		threads outside scheduler.
+		size_t GetQueueIndex() const;
+
+		/// Takes task from queue.
+		bool TryPop(Queue& queue, bool newest, TaskGroup* group, Entry& entry);
+
+		/// Runs single task, own one first, stolen one otherwise.
+		bool TryRun(size_t index, TaskGroup* group);
+
+		/// Runs worker loop.
+		void Work(size_t index);
+
+		/// Worker threads.
+		std::vector<std::thread> m_Threads;
+
+		/// Worker thread identifiers.
+		std::vector<std::thread::id> m_ThreadIds;
+
+		/// Task queues of workers, followed by queue shared by other threads.
+		std::vector<std::unique_ptr<Queue> > m_Queues;
+
+		/// The number of queued tasks.
+		std::atomic<int> m_Queued;
+
+		/// The mutex guarding sleeping workers.
+		std::mutex m_SleepMutex;
+
+		/// The condition signalled when task is queued.
+		std::condition_variable m_SleepCondition;
+
+		/// Determines whether workers may run.
+		bool m_Started;
+
+		/// Determines whether workers should exit.
+		bool m_Stop;
+	};
+
+	/// Runs task for subranges of range in parallel, or directly without scheduler.
+	///
+	/// @param[in] scheduler
+	///		The scheduler or nullptr.
+	/// @param[in] begin
+	///		The range begin.
+	/// @param[in] end
+	///		The range end.
+	/// @param[in] grain
+	///		The minimal size of subrange.
+	/// @param[in] task
+	///		The task receiving subrange begin and end.
+	inline void ParallelFor(TaskScheduler* scheduler, size_t begin, size_t end, size_t grain, const TaskScheduler::RangeTask& task)
+	{
+		if (scheduler != nullptr)
+		{
+			scheduler->ParallelFor(begin, end, grain, task);
+		}
+		else if (begin < end)
+		{
+			task(begin, end);
+		}
+	}
+}
+}
+
+#endif /* _Terremesh_Threading_TaskScheduler_H__ */